@@ -11,13 +11,9 @@
 #include "sharcfe.h"
 
 
-#define ENABLE_BLAST_PROCESSING		1
-
-
-
 #define CACHE_SIZE                      (2 * 1024 * 1024)
-#define COMPILE_BACKWARDS_BYTES         128
-#define COMPILE_FORWARDS_BYTES          512
+#define COMPILE_BACKWARDS_BYTES         SHARC_COMPILE_BACKWARDS
+#define COMPILE_FORWARDS_BYTES          SHARC_COMPILE_FORWARDS
 #define COMPILE_MAX_INSTRUCTIONS        ((COMPILE_BACKWARDS_BYTES/4) + (COMPILE_FORWARDS_BYTES/4))
 #define COMPILE_MAX_SEQUENCE            64
 
@@ -53,9 +49,6 @@ enum
 };
 
 
-#define ROPCODE(pc)     ((UINT64)(m_internal_ram[((pc-0x20000) * 3) + 0]) << 32) | \
-						((UINT64)(m_internal_ram[((pc-0x20000) * 3) + 1]) << 16) | \
-						((UINT64)(m_internal_ram[((pc-0x20000) * 3) + 2]) << 0)
 
 
 const device_type ADSP21062 = &device_creator<adsp21062_device>;
@@ -72,7 +65,22 @@ adsp21062_device::adsp21062_device(const machine_config &mconfig, const char *ta
 	, m_program_config("program", ENDIANNESS_LITTLE, 64, 24, -3, ADDRESS_MAP_NAME(internal_pgm))
 	, m_data_config("data", ENDIANNESS_LITTLE, 32, 32, -2)
 	, m_boot_mode(BOOT_MODE_HOST)
-	, m_cache(CACHE_SIZE + sizeof(sharc_internal_state))
+	, m_engine(SHARC_ENGINE_DRC)
+	, m_active_engine(SHARC_ENGINE_DRC)
+	, m_drc_profile(false)
+	, m_compile_queue(nullptr)
+	, m_compile_busy(false)
+	, m_compile_pc(0)
+	, m_compile_snapshot(false)
+	, m_compile_base(0)
+	, m_drc_fallback(false)
+	, m_drc_state_dirty(false)
+	, m_cache_size(CACHE_SIZE)
+	, m_cache(nullptr)
+	, m_cache_evictions(0)
+	, m_cache_refill(false)
+	, m_cache_refilling(false)
+	, m_fastram_select(0)
 	, m_drcuml(nullptr)
 	, m_drcfe(nullptr)
 {
@@ -165,7 +173,7 @@ void adsp21062_device::sharc_iop_w(UINT32 address, UINT32 data)
 		{
 			external_dma_write(m_core->extdma_shift,data);
 			m_core->extdma_shift++;
-			if(m_core->extdma_shift == 3)
+			if(m_core->extdma_shift >= dma_group_words((m_core->dma[6].control >> 6) & 0x3))
 				m_core->extdma_shift = 0;
 
 			#if 0
@@ -302,28 +310,104 @@ void adsp21062_device::external_dma_write(UINT32 address, UINT64 data)
 	first internal RAM location, before they are used by the DMA controller.
 	*/
 
-	switch ((m_core->dma[6].control >> 6) & 0x3)
+	int pmode = (m_core->dma[6].control >> 6) & 0x3;
+
+	if (pmode == DMA_PMODE_NO_PACKING)
 	{
-		case 2:         // 16/48 packing
-		{
-			int shift = address % 3;
-			UINT64 r = pm_read48((m_core->dma[6].int_index & 0x1ffff) | 0x20000);
+		dm_write32((m_core->dma[6].int_index & 0x1ffff) | 0x20000, (UINT32)data);
+		m_core->dma[6].int_index += m_core->dma[6].int_modifier;
+		return;
+	}
+
+	// 16/32, 16/48 and 32/48 packing, every word is merged into the internal words of its group
+	// right away, so the core sees the upload as it goes and a partial group is kept in the RAM
+	const dma_packing &p = s_dma_packing[pmode];
+	int shift = address % p.ext_words;
+	UINT32 dst[2];
+	UINT64 words[2];
+	UINT32 ext[6];
+
+	for (int n = 0; n < p.int_words; n++)
+	{
+		dst[n] = ((m_core->dma[6].int_index + n * m_core->dma[6].int_modifier) & 0x1ffff) | 0x20000;
+		words[n] = (p.int_bits == 48) ? pm_read48(dst[n]) : dm_read32(dst[n]);
+	}
 
-			r &= ~((UINT64)(0xffff) << (shift*16));
-			r |= (data & 0xffff) << (shift*16);
+	dma_unpack_groups(pmode, words, 1, ext);
+	ext[shift] = (UINT32)data;
+	dma_pack_groups(pmode, ext, 1, words);
 
-			pm_write48((m_core->dma[6].int_index & 0x1ffff) | 0x20000, r);
+	for (int n = 0; n < p.int_words; n++)
+	{
+		if (p.int_bits == 48)
+			pm_write48(dst[n], words[n]);
+		else
+			dm_write32(dst[n], (UINT32)words[n]);
+	}
+
+	if (shift == p.ext_words - 1)
+		m_core->dma[6].int_index += p.int_words * m_core->dma[6].int_modifier;
+}
 
-			if (shift == 2)
+/*
+    Host upload through the external port, count words from data written as if
+    external_dma_write was called for address, address + 1, ... in turn
+*/
+void adsp21062_device::external_dma_write(UINT32 address, const UINT32 *data, UINT32 count)
+{
+	int pmode = (m_core->dma[6].control >> 6) & 0x3;
+	const dma_packing &p = s_dma_packing[pmode];
+
+	// complete a group started by single writes
+	while (count > 0 && (address % p.ext_words) != 0)
+	{
+		external_dma_write(address++, *data++);
+		count--;
+	}
+
+	int groups = count / p.ext_words;
+	if (groups > 0)
+	{
+		int int_count = groups * p.int_words;
+		int modifier = m_core->dma[6].int_modifier;
+		UINT32 dst = (m_core->dma[6].int_index & 0x1ffff) | 0x20000;
+		bool done = false;
+
+		std::vector<UINT64> words(int_count);
+		dma_pack_groups(pmode, data, groups, words.data());
+
+		// whole words go to the internal RAM in one pass
+		if (modifier == 1)
+		{
+			if (p.int_bits == 48)
+				done = pm_write_span48(dst, words.data(), int_count);
+			else
 			{
-				m_core->dma[6].int_index += m_core->dma[6].int_modifier;
+				std::vector<UINT32> words32(words.begin(), words.end());
+				done = dm_write_span32(dst, words32.data(), int_count);
 			}
-			break;
 		}
-		default:
+
+		for (int n = 0; n < int_count && !done; n++)
 		{
-			fatalerror("sharc_external_dma_write: unimplemented packing mode %d\n", (m_core->dma[6].control >> 6) & 0x3);
+			dst = ((m_core->dma[6].int_index + n * modifier) & 0x1ffff) | 0x20000;
+			if (p.int_bits == 48)
+				pm_write48(dst, words[n]);
+			else
+				dm_write32(dst, (UINT32)words[n]);
 		}
+		m_core->dma[6].int_index += int_count * modifier;
+
+		address += groups * p.ext_words;
+		data += groups * p.ext_words;
+		count -= groups * p.ext_words;
+	}
+
+	// a partial group at the end is completed by later writes
+	while (count > 0)
+	{
+		external_dma_write(address++, *data++);
+		count--;
 	}
 }
 
@@ -331,7 +415,8 @@ void adsp21062_device::device_start()
 {
 	int saveindex;
 	
-	m_core = (sharc_internal_state *)m_cache.alloc_near(sizeof(sharc_internal_state));
+	m_cache = std::make_unique<drc_cache>(m_cache_size + sizeof(sharc_internal_state));
+	m_core = (sharc_internal_state *)m_cache->alloc_near(sizeof(sharc_internal_state));
 	memset(m_core, 0, sizeof(sharc_internal_state));
 
 	m_program = &space(AS_PROGRAM);
@@ -343,9 +428,11 @@ void adsp21062_device::device_start()
 	m_internal_ram_block0 = &m_internal_ram[0];
 	m_internal_ram_block1 = &m_internal_ram[0x20000/2];
 
+	build_memory_pages();
+
 	// init UML generator
 	UINT32 umlflags = 0;
-	m_drcuml = std::make_unique<drcuml_state>(*this, m_cache, umlflags, 1, 24, 0);
+	m_drcuml = std::make_unique<drcuml_state>(*this, *m_cache, umlflags, SHARC_CODE_VERSIONS, 24, 0);
 
 	// add UML symbols
 	m_drcuml->symbol_add(&m_core->pc, sizeof(m_core->pc), "pc");
@@ -418,10 +505,46 @@ void adsp21062_device::device_start()
 
 	m_drcfe = std::make_unique<sharc_frontend>(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, COMPILE_MAX_SEQUENCE);
 
-	for (int i = 0; i < 16; i++)
+	m_profile = std::make_unique<DRC_PROFILE_PAGE[]>(SHARC_CODE_PAGE_COUNT);
+	if (m_drc_profile)
+		load_drc_profile();
+
+	m_block_hits = std::make_unique<UINT32[]>(SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT);
+	m_block_hot = std::make_unique<UINT8[]>(SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT);
+	m_block_aliases = std::make_unique<UINT8[]>(SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT);
+
+	m_predecode = std::make_unique<SHARC_PREDECODE[]>(SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT);
+	for (int offset = 0; offset < (SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT); offset++)
 	{
-		m_regmap[i] = uml::mem(&m_core->r[i]);
+		// straight-line code is followed from one entry to the next without decoding the PC
+		bool last = ((offset + 1) & ((1 << SHARC_CODE_PAGE_SHIFT) - 1)) == 0;
+		m_predecode[offset].next = last ? nullptr : &m_predecode[offset + 1];
 	}
+	memset(m_predecode_stamp, 0, sizeof(m_predecode_stamp));
+	flush_predecode();
+	m_predecode_uncached.next = nullptr;
+	m_op = &m_predecode_uncached;
+	m_op_pc = 0;
+
+	m_code_stamp_seq = 0;
+	reset_code_versions();
+
+	// the background compile queue is made by switch_engine once the tiered engine is selected
+	m_active_engine = selected_engine();
+	memset(m_fallback_writes, 0, sizeof(m_fallback_writes));
+	memset(m_code_halfwords, 0, sizeof(m_code_halfwords));
+	memset(m_dag_hint, 0, sizeof(m_dag_hint));
+	memset(m_internal_ram48_dirty, 1, sizeof(m_internal_ram48_dirty));
+
+	// I0-I3 are scratch registers for the generated code, the directly mapped registers
+	// above them are handed out to the most used SHARC registers of each block
+	drcbe_info beinfo;
+	m_drcuml->get_backend_info(beinfo);
+	m_num_fast_iregs = (beinfo.direct_iregs > 4) ? (beinfo.direct_iregs - 4) : 0;
+	if (m_num_fast_iregs > uml::REG_I_COUNT - 4)
+		m_num_fast_iregs = uml::REG_I_COUNT - 4;
+
+	reset_fast_iregs();
 
 	m_cache_dirty = true;
 
@@ -512,9 +635,9 @@ void adsp21062_device::device_start()
 	m_core->systemreg_latency_reg = 0;
 	m_core->systemreg_latency_data = 0;
 	m_core->systemreg_previous_data = 0;
-	m_core->astat_old = 0;
-	m_core->astat_old_old = 0;
-	m_core->astat_old_old_old = 0;
+	memset(m_core->astat_ring, 0, sizeof(m_core->astat_ring));
+	m_core->astat_ring_pos = 0;
+	m_core->astat_lazy_op = ASTAT_LAZY_NONE;
 
 	m_core->fp0 = 0.0f;
 	m_core->fp1 = 1.0f;
@@ -569,6 +692,7 @@ void adsp21062_device::device_start()
 		save_item(NAME(m_core->dma[saveindex].ext_modifier), saveindex);
 		save_item(NAME(m_core->dma[saveindex].ext_count), saveindex);
 	}
+	save_item(NAME(m_core->extdma_shift));
 
 	save_item(NAME(m_core->mode1));
 	save_item(NAME(m_core->mode2));
@@ -633,9 +757,8 @@ void adsp21062_device::device_start()
 	save_item(NAME(m_core->systemreg_latency_data));
 	save_item(NAME(m_core->systemreg_previous_data));
 
-	save_item(NAME(m_core->astat_old));
-	save_item(NAME(m_core->astat_old_old));
-	save_item(NAME(m_core->astat_old_old_old));
+	save_item(NAME(m_core->astat_ring));
+	save_item(NAME(m_core->astat_ring_pos));
 
 	state_add( SHARC_PC,     "PC", m_core->pc).formatstr("%08X");
 	state_add( SHARC_PCSTK,  "PCSTK", m_core->pcstk).formatstr("%08X");
@@ -745,7 +868,12 @@ void adsp21062_device::device_start()
 
 void adsp21062_device::device_reset()
 {
+	switch_engine(false);
+
 	memset(m_internal_ram, 0, 2 * 0x10000 * sizeof(UINT16));
+	memset(m_internal_ram32, 0, sizeof(m_internal_ram32));
+	memset(m_internal_ram48, 0, sizeof(m_internal_ram48));
+	memset(m_internal_ram48_dirty, 0, sizeof(m_internal_ram48_dirty));
 
 	switch(m_boot_mode)
 	{
@@ -788,9 +916,97 @@ void adsp21062_device::device_reset()
 	m_core->idle = 0;
 	m_core->stky = 0x5400000;
 
+	// the internal RAM was cleared and maybe loaded behind the interpreter's back
+	flush_predecode();
+
 	m_core->lstkp = 0;
 	m_core->pcstkp = 0;
 	m_core->interrupt_active = 0;
+
+	// a block that was being compiled is from before the reset, drop it along with anything the interpreter made stale
+	if (m_drc_fallback)
+		m_cache_dirty = true;
+}
+
+void adsp21062_device::device_stop()
+{
+	if (m_compile_queue != nullptr)
+	{
+		wait_compile_block();
+		osd_work_queue_free(m_compile_queue);
+		m_compile_queue = nullptr;
+	}
+
+	if (m_drc_profile)
+		save_drc_profile();
+}
+
+void adsp21062_device::device_pre_save()
+{
+	// ASTAT and the loop registers are saved in the interpreter's form, they only need
+	// converting if compiled code has run since they were last in it
+	if (m_active_engine != SHARC_ENGINE_INTERPRETER && !m_drc_fallback && m_drc_state_dirty)
+		sync_fallback_state();
+}
+
+void adsp21062_device::device_post_load()
+{
+	// the 32-bit and 48-bit views aren't saved, rebuild them from the restored halfwords
+	for (int i = 0; i < 0x10000; i++)
+		m_internal_ram32[i] = (m_internal_ram[i * 2 + 0] << 16) | m_internal_ram[i * 2 + 1];
+	memset(m_internal_ram48_dirty, 1, sizeof(m_internal_ram48_dirty));
+	flush_predecode();
+
+	switch_engine(true);
+}
+
+SHARC_ENGINE adsp21062_device::selected_engine()
+{
+	// -nodrc runs every SHARC on the interpreter
+	if (!machine().options().drc())
+		return SHARC_ENGINE_INTERPRETER;
+	return m_engine;
+}
+
+void adsp21062_device::switch_engine(bool state_loaded)
+{
+	SHARC_ENGINE engine = selected_engine();
+
+	// nothing may be compiling over the state that is handed around below
+	wait_compile_block();
+
+	// only the tiered engine compiles in the background, the queue stays once it is made
+	if (engine == SHARC_ENGINE_TIERED && m_compile_queue == nullptr)
+		m_compile_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+
+	if (engine == SHARC_ENGINE_INTERPRETER)
+	{
+		// a loaded state is in the interpreter's form already
+		if (m_active_engine != SHARC_ENGINE_INTERPRETER && !m_drc_fallback && !state_loaded)
+			enter_fallback();
+
+		// the interpreter doesn't need the block that failed to compile
+		m_drc_fallback = false;
+		m_compile_error = nullptr;
+		m_fallback_loops.clear();
+		memset(m_fallback_writes, 0, sizeof(m_fallback_writes));
+	}
+	else if (m_active_engine == SHARC_ENGINE_INTERPRETER)
+	{
+		// the translations are from before the interpreter took over, the interpreter
+		// runs until the state can be handed to the recompiler
+		m_drc_fallback = true;
+		m_cache_dirty = true;
+	}
+	else if (state_loaded)
+	{
+		// the restored RAM may hold different code than the blocks were compiled from
+		m_drc_fallback = true;
+		m_fallback_loops.clear();
+		memset(m_fallback_writes, 0xff, sizeof(m_fallback_writes));
+	}
+
+	m_active_engine = engine;
 }
 
 
@@ -874,14 +1090,15 @@ void adsp21062_device::check_interrupts()
 
 void adsp21062_device::execute_run()
 {
-#if ENABLE_BLAST_PROCESSING
-	if (m_core->irq_pending != 0)
+	if (m_active_engine != SHARC_ENGINE_INTERPRETER)
 	{
-		m_core->idle = 0;
+		if (m_core->irq_pending != 0)
+		{
+			m_core->idle = 0;
+		}
+		execute_run_drc();
+		return;
 	}
-	execute_run_drc();
-	return;
-#endif
 
 	if (m_core->idle && m_core->irq_pending == 0)
 	{
@@ -894,95 +1111,202 @@ void adsp21062_device::execute_run()
 		m_core->idle = 0;
 	}
 
+	// the debugger has to see every instruction go through execute_op
+	bool threaded = (machine().debug_flags & DEBUG_FLAG_ENABLED) == 0;
+
 	while (m_core->icount > 0 && !m_core->idle)
 	{
-		m_core->pc = m_core->daddr;
-		m_core->daddr = m_core->faddr;
-		m_core->faddr = m_core->nfaddr;
-		m_core->nfaddr++;
+		execute_op();
+		if (threaded)
+			execute_chain();
+	}
+}
 
-		m_core->astat_old_old_old = m_core->astat_old_old;
-		m_core->astat_old_old = m_core->astat_old;
-		m_core->astat_old = m_core->astat;
+void adsp21062_device::execute_op()
+{
+	m_core->pc = m_core->daddr;
+	m_core->daddr = m_core->faddr;
+	m_core->faddr = m_core->nfaddr;
+	m_core->nfaddr++;
 
-		debugger_instruction_hook(this, m_core->pc);
+	debugger_instruction_hook(this, m_core->pc);
 
-		m_core->opcode = ROPCODE(m_core->pc);		
+	// internal RAM instructions are decoded once, until their page is written, the one
+	// following the previous instruction is reached through its link
+	SHARC_PREDECODE *op = (m_core->pc == m_op_pc + 1) ? m_op->next : nullptr;
+	if (op == nullptr && m_core->pc >= 0x20000 && m_core->pc < 0x40000)
+		op = &m_predecode[sharc_frontend::code_offset(m_core->pc)];
 
-		// handle looping
-		if (m_core->pc == m_core->laddr.addr)
+	if (op != nullptr)
+	{
+		UINT32 stamp = m_predecode_stamp[(op - m_predecode.get()) >> SHARC_CODE_PAGE_SHIFT];
+		if (op->stamp != stamp)
 		{
-			switch (m_core->laddr.loop_type)
-			{
-				case 0:     // arithmetic condition-based
-				{
-					int condition = m_core->laddr.code;
+			predecode_op(*op, read_ram48(m_core->pc, true));
+			op->stamp = stamp;
+		}
+		m_op = op;
+	}
+	else
+	{
+		predecode_op(m_predecode_uncached, read_ram48(m_core->pc, true));
+		m_op = &m_predecode_uncached;
+	}
+	m_op_pc = m_core->pc;
+	m_core->opcode = m_op->opcode;
 
-					{
-						UINT32 looptop = TOP_PC();
-						if (m_core->pc - looptop > 2)
-						{
-							m_core->astat = m_core->astat_old_old_old;
-						}
-					}
+	// conditional loops test their condition with the flags from the start of the instruction executed
+	// two before the loop end, which is not laddr - 2 when a jump or a return lands inside the loop
+	m_core->astat_ring[m_core->astat_ring_pos++ & 3] = m_core->astat;
 
-					if (DO_CONDITION_CODE(condition))
-					{
-						POP_LOOP();
-						POP_PC();
-					}
-					else
+	// handle looping
+	if (m_core->pc == m_core->laddr.addr)
+	{
+		switch (m_core->laddr.loop_type)
+		{
+			case 0:     // arithmetic condition-based
+			{
+				int condition = m_core->laddr.code;
+				UINT32 astat = m_core->astat;
+
+				{
+					UINT32 looptop = TOP_PC();
+					if (m_core->pc - looptop > 2)
 					{
-						CHANGE_PC(TOP_PC());
+						m_core->astat = m_core->astat_ring[(m_core->astat_ring_pos - 3) & 3];
 					}
+				}
 
-					m_core->astat = m_core->astat_old;
-					break;
+				if (DO_CONDITION_CODE(condition))
+				{
+					POP_LOOP();
+					POP_PC();
 				}
-				case 1:     // counter-based, length 1
+				else
 				{
-					//fatalerror("SHARC: counter-based loop, length 1 at %08X\n", m_pc);
-					//break;
+					CHANGE_PC(TOP_PC());
 				}
-				case 2:     // counter-based, length 2
+
+				m_core->astat = astat;
+				break;
+			}
+			case 1:     // counter-based, length 1
+			{
+				//fatalerror("SHARC: counter-based loop, length 1 at %08X\n", m_pc);
+				//break;
+			}
+			case 2:     // counter-based, length 2
+			{
+				//fatalerror("SHARC: counter-based loop, length 2 at %08X\n", m_pc);
+				//break;
+			}
+			case 3:     // counter-based, length >2
+			{
+				--m_core->lcstack[m_core->lstkp];
+				--m_core->curlcntr;
+				if (m_core->curlcntr == 0)
 				{
-					//fatalerror("SHARC: counter-based loop, length 2 at %08X\n", m_pc);
-					//break;
+					POP_LOOP();
+					POP_PC();
 				}
-				case 3:     // counter-based, length >2
+				else
 				{
-					--m_core->lcstack[m_core->lstkp];
-					--m_core->curlcntr;
-					if (m_core->curlcntr == 0)
-					{
-						POP_LOOP();
-						POP_PC();
-					}
-					else
-					{
-						CHANGE_PC(TOP_PC());
-					}
+					CHANGE_PC(TOP_PC());
 				}
 			}
 		}
+	}
 
-		(this->*m_sharc_op[(m_core->opcode >> 39) & 0x1ff])();
+	(this->*m_op->handler)();
 
 
 
 
-		// System register latency effect
-		if (m_core->systemreg_latency_cycles > 0)
+	// System register latency effect
+	if (m_core->systemreg_latency_cycles > 0)
+	{
+		--m_core->systemreg_latency_cycles;
+		if (m_core->systemreg_latency_cycles <= 0)
 		{
-			--m_core->systemreg_latency_cycles;
-			if (m_core->systemreg_latency_cycles <= 0)
-			{
-				systemreg_write_latency_effect();
-			}
+			systemreg_write_latency_effect();
 		}
+	}
+
+	--m_core->icount;
+}
+
+// run the straight-line code following the instruction execute_op just ran along the links of its
+// page, handler to handler. The loop end compares and the interrupt and range checks are done once
+// for the whole run by sizing it to end before laddr, the run stops at anything that leaves the
+// straight line, is decoded from a stale entry or starts a system register latency, for execute_op
+// to take over.
+// The handlers are member functions shared with the DRC fallback, so the dispatch is an indirect
+// call per instruction rather than a computed goto, which also keeps the core free of compiler
+// extensions.
+void adsp21062_device::execute_chain()
+{
+	if (m_core->idle || m_core->systemreg_latency_cycles > 0)
+		return;
+
+	UINT32 laddr = m_core->laddr.addr;
+	INT32 budget = m_core->icount;
+	if (laddr >= m_core->daddr)
+	{
+		UINT32 distance = laddr - m_core->daddr;
+		budget = std::min<INT32>(budget, distance);
+	}
+
+	const SHARC_PREDECODE *op = m_op;
+	while (budget-- > 0 && m_core->icount > 0)
+	{
+		// a taken branch or a delayed one moves the fetch addresses off the straight line
+		if (m_core->daddr != m_op_pc + 1 || m_core->faddr != m_core->daddr + 1 || m_core->nfaddr != m_core->faddr + 1)
+			break;
+
+		op = op->next;
+		if (op == nullptr || op->stamp != m_predecode_stamp[(op - m_predecode.get()) >> SHARC_CODE_PAGE_SHIFT])
+			break;
+
+		m_core->pc = m_core->daddr;
+		m_core->daddr = m_core->faddr;
+		m_core->faddr = m_core->nfaddr;
+		m_core->nfaddr++;
 
+		m_op = op;
+		m_op_pc = m_core->pc;
+		m_core->opcode = op->opcode;
+		m_core->astat_ring[m_core->astat_ring_pos++ & 3] = m_core->astat;
+
+		(this->*op->handler)();
 		--m_core->icount;
-	};
+
+		// loops pushed or popped by the instruction move the end of the run
+		if (m_core->idle || m_core->systemreg_latency_cycles > 0 || m_core->laddr.addr != laddr)
+		{
+			if (m_core->systemreg_latency_cycles > 0 && --m_core->systemreg_latency_cycles <= 0)
+				systemreg_write_latency_effect();
+			break;
+		}
+	}
+}
+
+void adsp21062_device::predecode_op(SHARC_PREDECODE &op, UINT64 opcode)
+{
+	op.opcode = opcode;
+	op.handler = m_sharc_op[(opcode >> 39) & 0x1ff];
+	op.compute = opcode & 0x7fffff;
+	op.compute_handler = compute_handler(op.compute);
+	op.cond = (opcode >> 33) & 0x1f;
+}
+
+void adsp21062_device::flush_predecode()
+{
+	// stamp 0 is never current, so the entries cleared on allocation are decoded on first use
+	for (int page = 0; page < SHARC_CODE_PAGE_COUNT; page++)
+	{
+		if (++m_predecode_stamp[page] == 0)
+			m_predecode_stamp[page] = 1;
+	}
 }
 
 bool adsp21062_device::memory_read(address_spacenum spacenum, offs_t offset, int size, UINT64 &value)
@@ -1054,19 +1378,9 @@ bool adsp21062_device::memory_readop(offs_t offset, int size, UINT64 &value)
 	int shift = 8 * (offset & 7);
 	offset >>= 3;
 
-	if (offset >= 0x20000 && offset < 0x28000)
-	{
-		UINT64 op = ((UINT64)(m_internal_ram_block0[((offset-0x20000) * 3) + 0]) << 32) |
-					((UINT64)(m_internal_ram_block0[((offset-0x20000) * 3) + 1]) << 16) |
-					((UINT64)(m_internal_ram_block0[((offset-0x20000) * 3) + 2]) << 0);
-		value = (op >> shift) & mask;
-		return true;
-	}
-	else if (offset >= 0x28000 && offset < 0x30000)
+	if (offset >= 0x20000 && offset < 0x30000)
 	{
-		UINT64 op = ((UINT64)(m_internal_ram_block1[((offset-0x28000) * 3) + 0]) << 32) |
-					((UINT64)(m_internal_ram_block1[((offset-0x28000) * 3) + 1]) << 16) |
-					((UINT64)(m_internal_ram_block1[((offset-0x28000) * 3) + 2]) << 0);
+		UINT64 op = read_ram48(offset, true);
 		value = (op >> shift) & mask;
 		return true;
 	}
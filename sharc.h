@@ -5,6 +5,9 @@
 #ifndef __SHARC_H__
 #define __SHARC_H__
 
+#include <atomic>
+#include <exception>
+
 #include "cpu/drcfe.h"
 #include "cpu/drcuml.h"
 
@@ -22,6 +25,13 @@ enum SHARC_BOOT_MODE
 	BOOT_MODE_NOBOOT
 };
 
+enum SHARC_ENGINE
+{
+	SHARC_ENGINE_INTERPRETER,
+	SHARC_ENGINE_DRC,
+	SHARC_ENGINE_TIERED			// DRC, the interpreter runs while blocks are compiled in the background
+};
+
 
 struct alignas(16) SHARC_DAG
 {
@@ -119,6 +129,9 @@ struct SHARC_DMA_OP
 #define OP_USERFLAG_COND_LOOP				0x00000002
 #define OP_USERFLAG_COND_FIELD				0x0000003c
 #define OP_USERFLAG_COND_FIELD_SHIFT		2
+#define OP_USERFLAG_CONDITIONAL				0x00000040
+#define OP_USERFLAG_LOOP_STATE				0x00000080
+#define OP_USERFLAG_CALL					0x00000100
 #define OP_USERFLAG_ASTAT_DELAY_COPY_AZ		0x00001000
 #define OP_USERFLAG_ASTAT_DELAY_COPY_AN		0x00002000
 #define OP_USERFLAG_ASTAT_DELAY_COPY_AC		0x00004000
@@ -130,10 +143,48 @@ struct SHARC_DMA_OP
 #define OP_USERFLAG_ASTAT_DELAY_COPY_BTF	0x00100000
 #define OP_USERFLAG_ASTAT_DELAY_COPY		0x001ff000
 
+// translated code is tracked in pages of internal PM (block 1 mirrors folded together)
+#define SHARC_CODE_PAGE_SHIFT				8
+#define SHARC_CODE_PAGE_COUNT				(0x10000 >> SHARC_CODE_PAGE_SHIFT)
+
+// each code page keeps the translations of this many different contents, one UML hash mode each
+#define SHARC_CODE_VERSIONS					4
+
+// writes over translated code are found in pages of internal RAM halfwords, three of them make a code page
+#define SHARC_IRAM_PAGE_SHIFT				8
+
+// instructions before and after the start of a block the frontend describes
+#define SHARC_COMPILE_BACKWARDS				128
+#define SHARC_COMPILE_FORWARDS				512
+// instructions copied for a background compile, with room for the delay slots of the last one
+#define SHARC_COMPILE_SNAPSHOT				(SHARC_COMPILE_BACKWARDS + SHARC_COMPILE_FORWARDS + 4)
+
+// external DM ranges the accessors read and write directly
+#define SHARC_MAX_FASTRAM					4
+
+// 48-bit view of internal RAM, rebuilt in pages of halfwords after 16/32-bit writes
+#define SHARC_IRAM48_WORDS					(0x10000 / 3)
+#define SHARC_IRAM48_PAGE_SHIFT				8
+
+// halfword index of the 32-bit view of internal RAM seen as UINT16, the even halfword is the upper half of a word
+#define SHARC_IRAM32_HALF_XOR				NATIVE_ENDIAN_VALUE_LE_BE(1,0)
+
 
 #define MCFG_SHARC_BOOT_MODE(boot_mode) \
 	adsp21062_device::set_boot_mode(*device, boot_mode);
 
+#define MCFG_SHARC_ENGINE(engine) \
+	adsp21062_device::set_engine(*device, engine);
+
+#define MCFG_SHARC_DRC_PROFILE(enable) \
+	adsp21062_device::set_drc_profile(*device, enable);
+
+#define MCFG_SHARC_DRC_BACKGROUND(enable) \
+	adsp21062_device::set_drc_background(*device, enable);
+
+#define MCFG_SHARC_DRC_CACHE_SIZE(size) \
+	adsp21062_device::set_drc_cache_size(*device, size);
+
 class sharc_frontend;
 
 class adsp21062_device : public cpu_device
@@ -146,10 +197,19 @@ public:
 
 	// static configuration helpers
 	static void set_boot_mode(device_t &device, const SHARC_BOOT_MODE boot_mode) { downcast<adsp21062_device &>(device).m_boot_mode = boot_mode; }
+	static void set_engine(device_t &device, const SHARC_ENGINE engine) { downcast<adsp21062_device &>(device).m_engine = engine; }
+	static void set_drc_profile(device_t &device, bool enable) { downcast<adsp21062_device &>(device).m_drc_profile = enable; }
+	static void set_drc_background(device_t &device, bool enable) { downcast<adsp21062_device &>(device).m_engine = enable ? SHARC_ENGINE_TIERED : SHARC_ENGINE_DRC; }
+	static void set_drc_cache_size(device_t &device, UINT32 size) { downcast<adsp21062_device &>(device).m_cache_size = size; }
+
+	// takes effect at the next reset or state load
+	void select_engine(SHARC_ENGINE engine) { m_engine = engine; }
 
 	void set_flag_input(int flag_num, int state);
 	void external_iop_write(UINT32 address, UINT32 data);
 	void external_dma_write(UINT32 address, UINT64 data);
+	void external_dma_write(UINT32 address, const UINT32 *data, UINT32 count);
+	void add_fastram(offs_t start, offs_t end, bool readonly, void *base);
 
 	TIMER_CALLBACK_MEMBER(sharc_iop_delayed_write_callback);
 	TIMER_CALLBACK_MEMBER(sharc_dma_callback);
@@ -167,6 +227,7 @@ public:
 	void sharc_cfunc_unimplemented_compute();
 	void sharc_cfunc_unimplemented_shiftimm();
 	void sharc_cfunc_write_snoop();
+	void sharc_cfunc_invalidate_code();
 
 	enum ASTAT_FLAGS
 	{
@@ -244,6 +305,9 @@ protected:
 	// device-level overrides
 	virtual void device_start() override;
 	virtual void device_reset() override;
+	virtual void device_stop() override;
+	virtual void device_pre_save() override;
+	virtual void device_post_load() override;
 
 	// device_execute_interface overrides
 	virtual UINT32 execute_min_cycles() const override { return 8; }
@@ -269,6 +333,12 @@ private:
 	address_space_config m_data_config;
 
 	typedef void (adsp21062_device::*opcode_func)();
+	typedef void (adsp21062_device::*compute_func)(UINT32 opcode);
+	typedef void (adsp21062_device::*compute2_func)(int, int);
+	typedef void (adsp21062_device::*compute3_func)(int, int, int);
+	typedef void (adsp21062_device::*compute4_func)(int, int, int, int);
+	typedef UINT32 (adsp21062_device::*compute_mr_func)(int, int);
+	typedef void (adsp21062_device::*compute6_func)(int, int, int, int, int, int);
 	struct SHARC_OP
 	{
 		UINT32 op_mask;
@@ -277,6 +347,17 @@ private:
 	};
 	static const SHARC_OP s_sharc_opcode_table[];
 
+	// ALU operation whose AZ/AN/AV/AC flags have not been written to astat_drc yet
+	enum ASTAT_LAZY_OP
+	{
+		ASTAT_LAZY_NONE = 0,			// astat_drc is up to date
+		ASTAT_LAZY_ADD,					// flags of astat_lazy_x + astat_lazy_y
+		ASTAT_LAZY_SUB,					// flags of astat_lazy_x - astat_lazy_y
+		ASTAT_LAZY_LOGIC,				// fixed-point result in astat_lazy_x, AV and AC clear
+		ASTAT_LAZY_FLOAT,				// floating-point result in astat_lazy_x, AV and AC clear
+		ASTAT_LAZY_UNKNOWN = -1			// compile time only, any of the above may be pending
+	};
+
 	struct ASTAT_DRC
 	{
 		union
@@ -386,9 +467,8 @@ private:
 		UINT32 systemreg_latency_data;
 		UINT32 systemreg_previous_data;
 
-		UINT32 astat_old;
-		UINT32 astat_old_old;
-		UINT32 astat_old_old_old;
+		UINT32 astat_ring[4];			// ASTAT at the start of the last four instructions, tested at the end of a conditional loop
+		UINT32 astat_ring_pos;			// slot of the next instruction, counting up
 
 		UINT32 arg0;
 		UINT32 arg1;
@@ -401,24 +481,98 @@ private:
 		ASTAT_DRC astat_drc;
 		ASTAT_DRC astat_drc_copy;
 		ASTAT_DRC astat_delay_copy;
+		UINT32 astat_lazy_op;
+		UINT32 astat_lazy_x;
+		UINT32 astat_lazy_y;
+		UINT32 loop_trips;
+		UINT32 loop_batch;
 		UINT32 dreg_temp;
 		UINT32 jmpdest;
 
 		float fp0;
 		float fp1;
 
-		UINT32 force_recompile;
+		UINT32 codepage_stamp[SHARC_CODE_PAGE_COUNT];
+		UINT32 codepage_slot[SHARC_CODE_PAGE_COUNT];		// UML hash mode of the page's current version
 	};
 
 	sharc_internal_state* m_core;
 
 	SHARC_BOOT_MODE m_boot_mode;
 
+	SHARC_ENGINE m_engine;				// engine asked for by the configuration
+	SHARC_ENGINE m_active_engine;		// engine running the CPU, changed at reset and state load only
+
+	// translation profile, saved on exit and used to precompile known entry points on the next run
+	struct DRC_PROFILE_LOOP
+	{
+		UINT32 pc;
+		UINT16 entrytype;
+		UINT8 looptype;
+		UINT8 condition;
+		UINT32 start_pc;
+	};
+
+	struct DRC_PROFILE_PAGE
+	{
+		bool loaded;					// page has data from the profile file
+		bool applied;					// page has been checked against the profile since the last flush
+		UINT64 hash;					// hash of the page contents the profile was recorded with
+		std::vector<UINT32> entries;	// entry points from the profile file
+		std::vector<DRC_PROFILE_LOOP> loops;
+		std::vector<UINT32> compiled;	// entry points compiled in this run
+	};
+
+	bool m_drc_profile;
+	std::unique_ptr<DRC_PROFILE_PAGE[]> m_profile;
+
+	// contents a code page has been compiled from, so that the blocks of an overlay loaded again can be reused
+	struct CODE_PAGE_VERSIONS
+	{
+		int current;							// slot matching the page contents, -1 if not known since the last write
+		int next;								// slot to reuse when all are taken
+		bool valid[SHARC_CODE_VERSIONS];
+		UINT64 hash[SHARC_CODE_VERSIONS];		// code_page_hash of the contents
+		UINT32 stamp[SHARC_CODE_VERSIONS];		// codepage_stamp the blocks were compiled with
+	};
+
+	CODE_PAGE_VERSIONS m_code_versions[SHARC_CODE_PAGE_COUNT];
+	UINT32 m_code_stamp_seq;					// last stamp handed out, stamps are never reused for other contents
+
+	// entry counts of blocks, indexed by code offset, halved after every refill
+	std::unique_ptr<UINT32[]> m_block_hits;
+	// blocks that have reached HOT_BLOCK_THRESHOLD, kept apart from the decaying counts
+	std::unique_ptr<UINT8[]> m_block_hot;
+	// mirrors of internal RAM block 1 each block was entered at, bit n for pc 0x20000 + n * 0x8000
+	std::unique_ptr<UINT8[]> m_block_aliases;
+
+	// background compilation, the interpreter runs the code while a block is compiled on the worker
+	osd_work_queue *m_compile_queue;
+	std::atomic<bool> m_compile_busy;					// worker is compiling m_compile_pc
+	UINT32 m_compile_pc;
+	bool m_compile_snapshot;							// the worker describes the code from m_compile_code
+	UINT32 m_compile_base;								// pc of m_compile_code[0]
+	UINT64 m_compile_code[SHARC_COMPILE_SNAPSHOT];		// opcodes around m_compile_pc when it was queued
+	std::exception_ptr m_compile_error;					// thrown by the worker, rethrown on the emulation thread
+	UINT32 m_dag_hint[16];								// DAG I registers when m_compile_pc was reached
+	bool m_drc_fallback;								// the interpreter owns the CPU state
+	bool m_drc_state_dirty;								// compiled code ran since the state was last in the interpreter's form
+	UINT32 m_fallback_writes[SHARC_CODE_PAGE_COUNT / 32];	// code pages written by the interpreter
+	std::vector<UINT32> m_fallback_loops;				// DO instructions run by the interpreter
+
 	// UML stuff
-	drc_cache m_cache;
+	UINT32 m_cache_size;							// bytes of translated code, set before the cache is created
+	std::unique_ptr<drc_cache> m_cache;
+	UINT32 m_cache_evictions;
+	bool m_cache_refill;							// the cache was evicted, compile the most used blocks again
+	bool m_cache_refilling;
 	std::unique_ptr<drcuml_state> m_drcuml;
 	std::unique_ptr<sharc_frontend> m_drcfe;
 	uml::parameter   m_regmap[16];
+	uml::parameter   m_dag_imap[16];				// DAG1 I0-I7, DAG2 I8-I15
+	uml::parameter   m_dag_mmap[16];				// DAG1 M0-M7, DAG2 M8-M15
+	int m_num_fast_iregs;							// UML registers above I3 mapped to host registers
+	uml::parameter   m_loopreg;						// trip count of a loop compiled as a native loop
 
 	uml::code_handle *m_entry;                      /* entry point */
 	uml::code_handle *m_nocode;                     /* nocode exception handler */
@@ -435,6 +589,7 @@ private:
 	uml::code_handle *m_pop_loop;
 	uml::code_handle *m_push_status;
 	uml::code_handle *m_pop_status;
+	uml::code_handle *m_astat_materialize;
 	uml::code_handle *m_exception[EXCEPTION_COUNT];		// exception handlers
 	uml::code_handle *m_swap_dag1_0_3;
 	uml::code_handle *m_swap_dag1_4_7;
@@ -451,8 +606,50 @@ private:
 	address_space *m_data;
 	opcode_func m_sharc_op[512];
 
+	// interpreter instructions decoded once per code offset, dropped a code page at a time when it is written
+	struct SHARC_PREDECODE
+	{
+		UINT64 opcode;
+		opcode_func handler;
+		compute_func compute_handler;	// COMPUTE, or the function specialized for the compute field
+		SHARC_PREDECODE *next;			// entry of the following code offset in the same page, linked once at start
+		UINT32 stamp;					// m_predecode_stamp of the page when decoded
+		UINT32 compute;					// compute field, bits 0-22
+		int cond;						// condition field, bits 33-37
+	};
+	std::unique_ptr<SHARC_PREDECODE[]> m_predecode;
+	UINT32 m_predecode_stamp[SHARC_CODE_PAGE_COUNT];
+	SHARC_PREDECODE m_predecode_uncached;		// instructions outside of the internal RAM
+	const SHARC_PREDECODE *m_op;				// instruction being executed
+	UINT32 m_op_pc;								// and its PC
+
 	UINT16 m_internal_ram[2 * 0x10000]; // 2x 128KB
 
+	// halfword pairs of both blocks as 32-bit words for normal word DM accesses
+	UINT32 m_internal_ram32[0x10000];
+
+	// 48-bit words of both blocks for instruction fetch and PX reads
+	UINT64 m_internal_ram48[2 * SHARC_IRAM48_WORDS];
+	UINT8 m_internal_ram48_dirty[(2 * 0x10000) >> SHARC_IRAM48_PAGE_SHIFT];
+
+	// external DM backed by host memory, in 32-bit words
+	struct fast_ram_info
+	{
+		offs_t start;
+		offs_t end;
+		bool readonly;
+		UINT32 *base;
+	};
+	fast_ram_info m_fastram[SHARC_MAX_FASTRAM];
+	int m_fastram_select;
+
+	// DRC accessor page tables: page kind in the top bits, halfword offset into m_internal_ram below
+	UINT32 m_dm_pages[0x80000 >> SHARC_CODE_PAGE_SHIFT];
+	UINT32 m_pm_pages[0x40000 >> SHARC_CODE_PAGE_SHIFT];
+	UINT8 m_iram_code_pages[(2 * 0x10000) >> SHARC_IRAM_PAGE_SHIFT];		// code page of each halfword page
+	UINT32 m_code_halfwords[(2 * 0x10000) / 32];							// internal RAM halfwords that hold translated instructions
+	UINT8 m_pc_code_pages[0x20000 >> SHARC_CODE_PAGE_SHIFT];				// code page of each PC page, mirrors folded
+
 	inline void CHANGE_PC(UINT32 newpc);
 	inline void CHANGE_PC_DELAYED(UINT32 newpc);
 	void sharc_iop_delayed_w(UINT32 reg, UINT32 data, int cycles);
@@ -461,12 +658,23 @@ private:
 	UINT32 pm_read32(UINT32 address);
 	void pm_write32(UINT32 address, UINT32 data);
 	UINT64 pm_read48(UINT32 address);
+	void sync_ram48_page(UINT32 page);
+	UINT64 read_ram48(UINT32 address, bool sync);
+	UINT64 read_code48(UINT32 address);
+	inline void mark_ram48_dirty(UINT32 index);
+	inline void write_ram16(UINT32 index, UINT16 data);
 	void pm_write48(UINT32 address, UINT64 data);
 	UINT32 dm_read32(UINT32 address);
 	void dm_write32(UINT32 address, UINT32 data);
+	const UINT32 *dm_read_span32(UINT32 address, UINT32 count);
+	bool dm_write_span32(UINT32 address, const UINT32 *data, UINT32 count);
+	bool pm_write_span48(UINT32 address, const UINT64 *data, UINT32 count);
 	void schedule_chained_dma_op(int channel, UINT32 dma_chain_ptr, int chained_direction);
 	void schedule_dma_op(int channel, UINT32 src, UINT32 dst, int src_modifier, int dst_modifier, int src_count, int dst_count, int pmode);
 	void dma_op(int channel);
+	int dma_group_words(int pmode);
+	void dma_pack(int pmode, UINT32 src, UINT32 dst, int src_modifier, int dst_modifier, int src_count);
+	void dma_unpack(int pmode, UINT32 src, UINT32 dst, int src_modifier, int dst_modifier, int src_count);
 	void sharc_dma_exec(int channel);
 	void add_systemreg_write_latency_effect(int sysreg, UINT32 data, UINT32 prev_data);
 	inline void swap_register(UINT32 *a, UINT32 *b);
@@ -475,7 +683,22 @@ private:
 	void SET_UREG(int ureg, UINT32 data);
 	void SHIFT_OPERATION_IMM(int shiftop, int data, int rn, int rx);
 	void COMPUTE(UINT32 opcode);
+	compute_func compute_handler(UINT32 opcode);
+	template <compute3_func Op> void compute_rn_rx_ry(UINT32 opcode);
+	template <compute2_func Op> void compute_rn_rx(UINT32 opcode);
+	template <compute2_func Op> void compute_rx_ry(UINT32 opcode);
+	template <compute6_func Op> void compute_multi(UINT32 opcode);
+	template <compute2_func Op> void compute_ai_rk(UINT32 opcode);
+	template <compute4_func Op> void compute_dual(UINT32 opcode);
+	template <compute_mr_func Op> void compute_rn_mr(UINT32 opcode);
+	template <bool Mrb> void compute_clear_mr(UINT32 opcode);
+	template <int Op> void compute_shift(UINT32 opcode);
+	void compute_multi_dual(UINT32 opcode);
 	void check_interrupts();
+	void execute_op();
+	void execute_chain();
+	void predecode_op(SHARC_PREDECODE &op, UINT64 opcode);
+	void flush_predecode();
 	inline void PUSH_PC(UINT32 pc);
 	inline UINT32 POP_PC();
 	inline UINT32 TOP_PC();
@@ -529,10 +752,10 @@ private:
 	void sharcop_nop();
 	void sharcop_idle();
 	void sharcop_unimplemented();
-	inline void compute_add(int rn, int rx, int ry);
-	inline void compute_sub(int rn, int rx, int ry);
-	inline void compute_add_ci(int rn, int rx, int ry);
-	inline void compute_sub_ci(int rn, int rx, int ry);
+	template <bool Saturate> inline void compute_add(int rn, int rx, int ry);
+	template <bool Saturate> inline void compute_sub(int rn, int rx, int ry);
+	template <bool Saturate> inline void compute_add_ci(int rn, int rx, int ry);
+	template <bool Saturate> inline void compute_sub_ci(int rn, int rx, int ry);
 	inline void compute_and(int rn, int rx, int ry);
 	inline void compute_comp(int rx, int ry);
 	inline void compute_pass(int rn, int rx);
@@ -546,8 +769,8 @@ private:
 	inline void compute_not(int rn, int rx);
 	inline UINT32 SCALB(SHARC_REG rx, int ry);
 	inline void compute_float(int rn, int rx);
-	inline void compute_fix(int rn, int rx);
-	inline void compute_fix_scaled(int rn, int rx, int ry);
+	template <bool Truncate> inline void compute_fix(int rn, int rx);
+	template <bool Truncate> inline void compute_fix_scaled(int rn, int rx, int ry);
 	inline void compute_float_scaled(int rn, int rx, int ry);
 	inline void compute_logb(int rn, int rx);
 	inline void compute_scalb(int rn, int rx, int ry);
@@ -578,8 +801,8 @@ private:
 	inline void compute_fmul_fadd(int fm, int fxm, int fym, int fa, int fxa, int fya);
 	inline void compute_fmul_fsub(int fm, int fxm, int fym, int fa, int fxa, int fya);
 	inline void compute_fmul_float_scaled(int fm, int fxm, int fym, int fa, int fxa, int fya);
-	inline void compute_fmul_fix_scaled(int fm, int fxm, int fym, int fa, int fxa, int fya);
-	inline void compute_fmul_avg(int fm, int fxm, int fym, int fa, int fxa, int fya);
+	template <bool Truncate> inline void compute_fmul_fix_scaled(int fm, int fxm, int fym, int fa, int fxa, int fya);
+	template <bool Truncate> inline void compute_fmul_avg(int fm, int fxm, int fym, int fa, int fxa, int fya);
 	inline void compute_fmul_fmax(int fm, int fxm, int fym, int fa, int fxa, int fya);
 	inline void compute_fmul_fmin(int fm, int fxm, int fym, int fa, int fxa, int fya);
 	inline void compute_fmul_dual_fadd_fsub(int fm, int fxm, int fym, int fa, int fs, int fxa, int fya);
@@ -597,15 +820,48 @@ private:
 			int mode;
 			UINT32 data;
 		} mode1_delay;
+		int astat_lazy;							   /* ASTAT_LAZY_OP pending at this point */
+		bool astat_lazy_recorded;				   /* current instruction deferred its ALU flags */
+		UINT8  native_loop;						   /* compiling the body of a native counter loop */
+		UINT8  return_sites;					   /* dynamic jumps check the return sites of the block's calls */
+		const opcode_desc *desclist;			   /* descriptors of the block being compiled */
 	};
 
 	void execute_run_drc();
+	SHARC_ENGINE selected_engine();
+	void switch_engine(bool state_loaded);
+	static void *compile_block_worker(void *param, int threadid);
+	void queue_compile_block(UINT32 pc);
+	void wait_compile_block();
+	bool execute_fallback();
+	void enter_fallback();
+	void sync_fallback_state();
+	bool leave_fallback();
+	void astat_drc_materialize();
+	UINT32 astat_drc_pack(const ASTAT_DRC &astat);
+	void astat_drc_unpack(ASTAT_DRC &astat, UINT32 data);
 	void flush_cache();
+	void evict_cache();
+	void refill_cache();
+	void static_generate_handlers();
 	void compile_block(offs_t pc);
+	bool prepare_block(UINT32 pc);
+	void invalidate_code_page(UINT32 page, bool overwritten = false);
+	UINT64 code_page_hash(UINT32 page);
+	void reset_code_versions();
+	bool select_code_version(UINT32 page);
+	void load_drc_profile();
+	void save_drc_profile();
+	void apply_drc_profile(UINT32 pc);
 	void alloc_handle(drcuml_state *drcuml, uml::code_handle **handleptr, const char *name);
 	void static_generate_entry_point();
 	void static_generate_nocode_handler();
 	void static_generate_out_of_cycles();
+	void build_memory_pages();
+	void generate_code_write_check(drcuml_block *block, uml::code_label skip, int count);
+	void generate_code_slot(drcuml_block *block, uml::parameter pc);
+	inline void check_code_write(UINT32 index, UINT32 count);
+	inline void check_code_span(UINT32 first, UINT32 last);
 	void static_generate_memory_accessor(MEM_ACCESSOR_TYPE type, const char *name, uml::code_handle *&handleptr);
 	void static_generate_exception(UINT8 exception, const char *name);
 	void static_generate_push_pc();
@@ -615,10 +871,17 @@ private:
 	void static_generate_push_status();
 	void static_generate_pop_status();
 	void static_generate_mode1_ops();
+	void static_generate_astat_materialize();
 	void load_fast_iregs(drcuml_block *block);
 	void save_fast_iregs(drcuml_block *block);
+	void reset_fast_iregs();
+	void alloc_fast_iregs(const opcode_desc *desclist, int reserve);
 	void generate_sequence_instruction(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc);
 	void generate_update_cycles(drcuml_block *block, compiler_state *compiler, uml::parameter param, int allow_exception);
+	void generate_code_page_check(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, const opcode_desc *seqlast);
+	void generate_native_loop(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, const opcode_desc *loopend);
+	void generate_block_counter(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, bool promote);
+	void generate_return_sites(drcuml_block *block, compiler_state *compiler);
 	int generate_opcode(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc);
 	void generate_unimplemented_compute(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc);
 	void generate_compute(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc);
@@ -633,8 +896,12 @@ private:
 	void generate_toggle_mode1_imm(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, UINT32 data);
 	void generate_read_ureg(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int ureg, bool has_compute);
 	void generate_write_ureg(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int ureg, bool imm, UINT32 data);
+	void generate_read_memory(drcuml_block *block, compiler_state *compiler, int g, bool px48, UINT32 hint);
+	void generate_write_memory(drcuml_block *block, compiler_state *compiler, int g, bool px48, UINT32 hint);
 	void generate_update_circular_buffer(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int g, int i);
 	void generate_astat_copy(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc);
+	bool generate_astat_lazy(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int op, uml::parameter x, uml::parameter y);
+	void generate_astat_materialize(drcuml_block *block, compiler_state *compiler);
 
 	bool if_condition_always_true(int condition);
 	UINT32 do_condition_astat_bits(int condition);
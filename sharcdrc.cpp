@@ -20,6 +20,9 @@ using namespace uml;
 #define USE_SWAPDQ	1
 #define WRITE_SNOOP 0
 
+#define DRC_PROFILE_MAGIC		0x43524453		// 'SDRC'
+#define DRC_PROFILE_VERSION		1
+
 
 // map variables
 #define MAPVAR_PC                       M0
@@ -30,15 +33,24 @@ using namespace uml;
 #define EXECUTE_MISSING_CODE            1
 #define EXECUTE_UNMAPPED_CODE           2
 #define EXECUTE_RESET_CACHE             3
+#define EXECUTE_HOT_BLOCK               4
+
+// a block entered this many times is recompiled with return sites, from the same
+// describe window, this is not a trace or superblock former and keeps no path profile
+#define HOT_BLOCK_THRESHOLD             1024
+// most call sites a dynamic jump target is compared against
+#define HOT_RETURN_SITES                8
+// how full the cache is filled again with the most used blocks after an eviction
+#define CACHE_REFILL_PERCENT            50
 
 
 #define REG(reg)						m_regmap[reg]
-#define DM_I(reg)						mem(&m_core->dag1.i[reg])
-#define DM_M(reg)						mem(&m_core->dag1.m[reg])
+#define DM_I(reg)						m_dag_imap[reg]
+#define DM_M(reg)						m_dag_mmap[reg]
 #define DM_L(reg)						mem(&m_core->dag1.l[reg])
 #define DM_B(reg)						mem(&m_core->dag1.b[reg])
-#define PM_I(reg)						mem(&m_core->dag2.i[reg])
-#define PM_M(reg)						mem(&m_core->dag2.m[reg])
+#define PM_I(reg)						m_dag_imap[8 + (reg)]
+#define PM_M(reg)						m_dag_mmap[8 + (reg)]
 #define PM_L(reg)						mem(&m_core->dag2.l[reg])
 #define PM_B(reg)						mem(&m_core->dag2.b[reg])
 #define ASTAT_AZ						mem(&m_core->astat_drc.az)
@@ -77,21 +89,23 @@ using namespace uml;
 #define MRB								mem(&m_core->mrb)
 
 //#define ASTAT_CALC_REQUIRED				desc->regreq[0] & 0x10000
-#define AZ_CALC_REQUIRED				((desc->regreq[0] & 0x00010000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AV_CALC_REQUIRED				((desc->regreq[0] & 0x00020000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AN_CALC_REQUIRED				((desc->regreq[0] & 0x00040000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AC_CALC_REQUIRED				((desc->regreq[0] & 0x00080000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AS_CALC_REQUIRED				((desc->regreq[0] & 0x00100000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AI_CALC_REQUIRED				((desc->regreq[0] & 0x00200000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define MN_CALC_REQUIRED				((desc->regreq[0] & 0x00400000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define MV_CALC_REQUIRED				((desc->regreq[0] & 0x00800000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define MU_CALC_REQUIRED				((desc->regreq[0] & 0x01000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define MI_CALC_REQUIRED				((desc->regreq[0] & 0x02000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define SV_CALC_REQUIRED				((desc->regreq[0] & 0x04000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define SZ_CALC_REQUIRED				((desc->regreq[0] & 0x08000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define SS_CALC_REQUIRED				((desc->regreq[0] & 0x10000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define BTF_CALC_REQUIRED				((desc->regreq[0] & 0x20000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
-#define AF_CALC_REQUIRED				((desc->regreq[0] & 0x40000000) || desc->flags & OPFLAG_IN_DELAY_SLOT)
+#define AZ_CALC_REQUIRED				(desc->regreq[0] & 0x00010000)
+#define AV_CALC_REQUIRED				(desc->regreq[0] & 0x00020000)
+#define AN_CALC_REQUIRED				(desc->regreq[0] & 0x00040000)
+#define AC_CALC_REQUIRED				(desc->regreq[0] & 0x00080000)
+#define AS_CALC_REQUIRED				(desc->regreq[0] & 0x00100000)
+#define AI_CALC_REQUIRED				(desc->regreq[0] & 0x00200000)
+#define MN_CALC_REQUIRED				(desc->regreq[0] & 0x00400000)
+#define MV_CALC_REQUIRED				(desc->regreq[0] & 0x00800000)
+#define MU_CALC_REQUIRED				(desc->regreq[0] & 0x01000000)
+#define MI_CALC_REQUIRED				(desc->regreq[0] & 0x02000000)
+#define SV_CALC_REQUIRED				(desc->regreq[0] & 0x04000000)
+#define SZ_CALC_REQUIRED				(desc->regreq[0] & 0x08000000)
+#define SS_CALC_REQUIRED				(desc->regreq[0] & 0x10000000)
+#define BTF_CALC_REQUIRED				(desc->regreq[0] & 0x20000000)
+#define AF_CALC_REQUIRED				(desc->regreq[0] & 0x40000000)
+
+#define ASTAT_LAZY_FLAGS				0x000f0000		// AZ, AV, AN, AC
 
 
 #define IRAM_BLOCK0_START				0x20000
@@ -106,6 +120,17 @@ using namespace uml;
 #define IOP_REGISTER_END				0x000ff
 #define IRAM_END						0x7ffff
 
+#define IRAM_DM_WINDOW					0x8000			// 32-bit words in an internal RAM block
+#define IRAM_PM_WINDOW					(0x10000 / 3)	// 48-bit words in an internal RAM block
+
+#define MEM_PAGE_SHIFT					SHARC_CODE_PAGE_SHIFT		// a memory page never spans two code pages
+#define MEM_PAGE_MASK					((1 << MEM_PAGE_SHIFT) - 1)
+#define MEM_PAGE_BASE_MASK				0x000fffff		// halfword offset into m_internal_ram
+#define MEM_PAGE_RAM					0x00000000
+#define MEM_PAGE_SHORT					0x10000000
+#define MEM_PAGE_IOP					0x20000000
+#define MEM_PAGE_NONE					0x30000000
+
 
 inline void adsp21062_device::alloc_handle(drcuml_state *drcuml, code_handle **handleptr, const char *name)
 {
@@ -182,6 +207,20 @@ static void cfunc_unimplemented_shiftimm(void *param)
 }
 
 
+void adsp21062_device::sharc_cfunc_invalidate_code()
+{
+	UINT32 page = m_iram_code_pages[m_core->arg2 >> SHARC_IRAM_PAGE_SHIFT];
+	if (m_drcfe->codemap()[page])
+		invalidate_code_page(page, true);
+}
+
+static void cfunc_invalidate_code(void *param)
+{
+	adsp21062_device *sharc = (adsp21062_device *)param;
+	sharc->sharc_cfunc_invalidate_code();
+}
+
+
 #if WRITE_SNOOP
 void adsp21062_device::sharc_cfunc_write_snoop()
 {
@@ -309,6 +348,14 @@ inline void adsp21062_device::load_fast_iregs(drcuml_block *block)
 		{
 			UML_MOV(block, ireg(m_regmap[regnum].ireg() - REG_I0), mem(&m_core->r[regnum]));
 		}
+		if (m_dag_imap[regnum].is_int_register())
+		{
+			UML_MOV(block, ireg(m_dag_imap[regnum].ireg() - REG_I0), mem((regnum < 8) ? &m_core->dag1.i[regnum] : &m_core->dag2.i[regnum & 7]));
+		}
+		if (m_dag_mmap[regnum].is_int_register())
+		{
+			UML_MOV(block, ireg(m_dag_mmap[regnum].ireg() - REG_I0), mem((regnum < 8) ? &m_core->dag1.m[regnum] : &m_core->dag2.m[regnum & 7]));
+		}
 	}
 }
 
@@ -328,7 +375,184 @@ void adsp21062_device::save_fast_iregs(drcuml_block *block)
 		{
 			UML_MOV(block, mem(&m_core->r[regnum]), ireg(m_regmap[regnum].ireg() - REG_I0));
 		}
+		if (m_dag_imap[regnum].is_int_register())
+		{
+			UML_MOV(block, mem((regnum < 8) ? &m_core->dag1.i[regnum] : &m_core->dag2.i[regnum & 7]), ireg(m_dag_imap[regnum].ireg() - REG_I0));
+		}
+		if (m_dag_mmap[regnum].is_int_register())
+		{
+			UML_MOV(block, mem((regnum < 8) ? &m_core->dag1.m[regnum] : &m_core->dag2.m[regnum & 7]), ireg(m_dag_mmap[regnum].ireg() - REG_I0));
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+reset_fast_iregs - map all registers back to
+memory
+-------------------------------------------------*/
+
+void adsp21062_device::reset_fast_iregs()
+{
+	for (int i = 0; i < 16; i++)
+	{
+		m_regmap[i] = uml::mem(&m_core->r[i]);
+		m_dag_imap[i] = uml::mem((i < 8) ? &m_core->dag1.i[i] : &m_core->dag2.i[i & 7]);
+		m_dag_mmap[i] = uml::mem((i < 8) ? &m_core->dag1.m[i] : &m_core->dag2.m[i & 7]);
+	}
+	m_loopreg = uml::mem(&m_core->loop_trips);
+}
+
+
+/*-------------------------------------------------
+alloc_fast_iregs - map the most used R and DAG
+I/M registers of a block to UML registers,
+keeping the last one for the native loop trip
+count if reserve is set
+-------------------------------------------------*/
+
+void adsp21062_device::alloc_fast_iregs(const opcode_desc *desclist, int reserve)
+{
+	// 0-15 = R0-R15, 16-31 = I0-I15, 32-47 = M0-M15
+	int usage[48] = { 0 };
+
+	reset_fast_iregs();
+
+	if (m_num_fast_iregs == 0)
+		return;
+
+	int num_iregs = m_num_fast_iregs;
+	if (reserve)
+	{
+		num_iregs--;
+		m_loopreg = uml::parameter::make_ireg(uml::REG_I0 + 4 + num_iregs);
+	}
+
+	for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			usage[i] += ((desc->regin[0] >> i) & 1) + ((desc->regout[0] >> i) & 1);
+		}
+		for (int i = 0; i < 8; i++)
+		{
+			// frontend keeps DAG1 in regin/regout[2] and DAG2 in regin/regout[1]
+			usage[16 + i] += ((desc->regin[2] >> i) & 1) + ((desc->regout[2] >> i) & 1);
+			usage[24 + i] += ((desc->regin[1] >> i) & 1) + ((desc->regout[1] >> i) & 1);
+			usage[32 + i] += ((desc->regin[2] >> (i + 8)) & 1) + ((desc->regout[2] >> (i + 8)) & 1);
+			usage[40 + i] += ((desc->regin[1] >> (i + 8)) & 1) + ((desc->regout[1] >> (i + 8)) & 1);
+		}
+	}
+
+	for (int r = 0; r < num_iregs; r++)
+	{
+		int best = -1;
+		for (int i = 0; i < 48; i++)
+		{
+			if (best < 0 || usage[i] > usage[best])
+				best = i;
+		}
+
+		// a register used only once doesn't pay for the load and store
+		if (usage[best] < 2)
+			break;
+		usage[best] = 0;
+
+		uml::parameter param = uml::parameter::make_ireg(uml::REG_I0 + 4 + r);
+		if (best < 16)
+			m_regmap[best] = param;
+		else if (best < 32)
+			m_dag_imap[best - 16] = param;
+		else
+			m_dag_mmap[best - 32] = param;
+	}
+}
+
+/*-------------------------------------------------
+build_memory_pages - fill the page tables the
+memory accessors dispatch through
+-------------------------------------------------*/
+
+void adsp21062_device::build_memory_pages()
+{
+	for (UINT32 page = 0; page < ARRAY_LENGTH(m_dm_pages); page++)
+	{
+		UINT32 address = page << MEM_PAGE_SHIFT;
+
+		if (address <= IOP_REGISTER_END)
+			m_dm_pages[page] = MEM_PAGE_IOP;
+		else if (address >= IRAM_BLOCK0_START && address <= IRAM_BLOCK0_END)
+			m_dm_pages[page] = MEM_PAGE_RAM | ((address & 0x7fff) * 2);
+		else if (address >= IRAM_BLOCK1_START && address <= IRAM_BLOCK1_END)
+			m_dm_pages[page] = MEM_PAGE_RAM | (0x10000 + (address & 0x7fff) * 2);		// block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff
+		else if (address >= IRAM_SHORT_BLOCK0_START && address <= IRAM_SHORT_BLOCK0_END)
+			m_dm_pages[page] = MEM_PAGE_SHORT | (address & 0xffff);
+		else if (address >= IRAM_SHORT_BLOCK1_START && address <= IRAM_SHORT_BLOCK1_END)
+			m_dm_pages[page] = MEM_PAGE_SHORT | (0x10000 + (address & 0xffff));
+		else
+			m_dm_pages[page] = MEM_PAGE_NONE;
+	}
+
+	for (UINT32 page = 0; page < ARRAY_LENGTH(m_pm_pages); page++)
+	{
+		UINT32 address = page << MEM_PAGE_SHIFT;
+
+		if (address >= IRAM_BLOCK0_START && address <= IRAM_BLOCK0_END)
+			m_pm_pages[page] = MEM_PAGE_RAM | ((address & 0x7fff) * 3);
+		else if (address >= IRAM_BLOCK1_START && address <= IRAM_BLOCK1_END)
+			m_pm_pages[page] = MEM_PAGE_RAM | (0x10000 + (address & 0x7fff) * 3);
+		else
+			m_pm_pages[page] = MEM_PAGE_NONE;
 	}
+
+	for (UINT32 page = 0; page < ARRAY_LENGTH(m_iram_code_pages); page++)
+	{
+		UINT32 block = page >> (16 - SHARC_IRAM_PAGE_SHIFT);
+		UINT32 word = ((page << SHARC_IRAM_PAGE_SHIFT) & 0xffff) / 3;
+
+		m_iram_code_pages[page] = (block << (15 - SHARC_CODE_PAGE_SHIFT)) | (word >> SHARC_CODE_PAGE_SHIFT);
+	}
+
+	for (UINT32 page = 0; page < ARRAY_LENGTH(m_pc_code_pages); page++)
+		m_pc_code_pages[page] = sharc_frontend::code_page(page << SHARC_CODE_PAGE_SHIFT);
+}
+
+
+/*-------------------------------------------------
+generate_code_write_check - invalidate the
+translated code a write to count internal RAM
+halfwords from I2 lands on, keeping I0 and I1
+-------------------------------------------------*/
+
+void adsp21062_device::generate_code_write_check(drcuml_block *block, code_label skip, int count)
+{
+	/* data sharing a page with code leaves the code alone */
+	UML_MOV(block, mem(&m_core->arg2), I2);								// mov     [arg2],i2
+	UML_SHR(block, I2, I2, 5);											// shr     i2,i2,5
+	UML_LOAD(block, I2, m_code_halfwords, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[code_halfwords],i2,dword,scale_x4
+	UML_SHR(block, I2, I2, mem(&m_core->arg2));							// shr     i2,i2,[arg2]
+	UML_TEST(block, I2, (1 << count) - 1);								// test    i2,(1 << count)-1
+	UML_JMPc(block, COND_Z, skip);										// jz      skip
+	UML_DMOV(block, mem(&m_core->arg64), I0);							// dmov    [arg64],i0
+	UML_MOV(block, mem(&m_core->arg3), I1);								// mov     [arg3],i1
+	UML_CALLC(block, cfunc_invalidate_code, this);						// callc   cfunc_invalidate_code
+	UML_DMOV(block, I0, mem(&m_core->arg64));							// dmov    i0,[arg64]
+	UML_MOV(block, I1, mem(&m_core->arg3));								// mov     i1,[arg3]
+	UML_LABEL(block, skip);												// skip:
+}
+
+
+/*-------------------------------------------------
+generate_code_slot - load the hash mode of the
+code page holding pc into I1
+-------------------------------------------------*/
+
+void adsp21062_device::generate_code_slot(drcuml_block *block, parameter pc)
+{
+	UML_SHR(block, I1, pc, SHARC_CODE_PAGE_SHIFT);									// shr     i1,pc,SHARC_CODE_PAGE_SHIFT
+	UML_AND(block, I1, I1, ARRAY_LENGTH(m_pc_code_pages) - 1);						// and     i1,i1,pc_code_pages mask
+	UML_LOAD(block, I1, m_pc_code_pages, I1, SIZE_BYTE, SCALE_x1);					// load    i1,[pc_code_pages],i1,byte,scale_x1
+	UML_LOAD(block, I1, m_core->codepage_slot, I1, SIZE_DWORD, SCALE_x4);			// load    i1,[codepage_slot],i1,dword,scale_x4
 }
 
 void adsp21062_device::static_generate_memory_accessor(MEM_ACCESSOR_TYPE type, const char *name, code_handle *&handleptr)
@@ -337,12 +561,14 @@ void adsp21062_device::static_generate_memory_accessor(MEM_ACCESSOR_TYPE type, c
 	// I1 = address
 	// I2 is trashed
 
-	void* block0 = &m_internal_ram_block0[0];
-	void* block0_1 = &m_internal_ram_block0[1];
-	void* block0_2 = &m_internal_ram_block0[2];
-	void* block1 = &m_internal_ram_block1[0];
-	void* block1_1 = &m_internal_ram_block1[1];
-	void* block1_2 = &m_internal_ram_block1[2];
+	// the page tables give halfword offsets into the internal RAM
+	void* ram = &m_internal_ram[0];
+	void* ram_1 = &m_internal_ram[1];
+	void* ram_2 = &m_internal_ram[2];
+
+	// the 32-bit view, as words and as halfwords
+	void* ram32 = &m_internal_ram32[0];
+	void* ram32_16 = reinterpret_cast<UINT16 *>(m_internal_ram32);
 
 	code_label label = 1;
 
@@ -355,223 +581,208 @@ void adsp21062_device::static_generate_memory_accessor(MEM_ACCESSOR_TYPE type, c
 	switch (type)
 	{
 		case MEM_ACCESSOR_PM_READ48:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label1
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
+			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
 			UML_JMPc(block, COND_A, label);								// ja      label1
-			
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_pm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[pm_pages],i2,dword,scale_x4
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label);							// jae     label1
+
+			// 0x20000 ... 0x3ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
 			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_DLOAD(block, I0, block0, I1, SIZE_WORD, SCALE_x2);		// dload   i0,[block0],i1,word,scale_x2
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+			UML_DLOAD(block, I0, ram, I1, SIZE_WORD, SCALE_x2);			// dload   i0,[ram],i1,word,scale_x2
 			UML_DSHL(block, I0, I0, 32);								// dshl    i0,i0,32
-			UML_DLOAD(block, I2, block0_1, I1, SIZE_WORD, SCALE_x2);	// dload   i2,[block0_1],i1,word,scale_x2
+			UML_DLOAD(block, I2, ram_1, I1, SIZE_WORD, SCALE_x2);		// dload   i2,[ram_1],i1,word,scale_x2
 			UML_DSHL(block, I2, I2, 16);								// dshl    i2,i2,16
 			UML_DOR(block, I0, I0, I2);									// dor     i0,i0,i2
-			UML_DLOAD(block, I2, block0_2, I1, SIZE_WORD, SCALE_x2);	// dload   i2,[block0_2],i1,word,scale_x2
+			UML_DLOAD(block, I2, ram_2, I1, SIZE_WORD, SCALE_x2);		// dload   i2,[ram_2],i1,word,scale_x2
 			UML_DOR(block, I0, I0, I2);									// dor     i0,i0,i2
 			UML_RET(block);												// ret
 
 			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
-			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-
-			// 0x28000  ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff (block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff)
-			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_DLOAD(block, I0, block1, I1, SIZE_WORD, SCALE_x2);		// dload   i0,[block1],i1,word,scale_x2
-			UML_DSHL(block, I0, I0, 32);								// dshl    i0,i0,32
-			UML_DLOAD(block, I2, block1_1, I1, SIZE_WORD, SCALE_x2);	// dload   i2,[block1_1],i1,word,scale_x2
-			UML_DSHL(block, I2, I2, 16);								// dshl    i2,i2,16
-			UML_DOR(block, I0, I0, I2);									// dor     i0,i0,i2
-			UML_DLOAD(block, I2, block1_2, I1, SIZE_WORD, SCALE_x2);	// dload   i2,[block1_2],i1,word,scale_x2
-			UML_DOR(block, I0, I0, I2);									// dor     i0,i0,i2
-			UML_RET(block);												// ret
-
-			UML_LABEL(block, label++);									// label2:
 			break;
 
 		case MEM_ACCESSOR_PM_WRITE48:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label1
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
-			UML_JMPc(block, COND_A, label);								// ja      label1
-
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
-			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_DSTORE(block, block0_2, I1, I0, SIZE_WORD, SCALE_x2);	// dstore  [block0_2],i1,i0,word,scale_x2
-			UML_DSHR(block, I0, I0, 16);								// dshr    i0,i0,16
-			UML_DSTORE(block, block0_1, I1, I0, SIZE_WORD, SCALE_x2);	// dstore  [block0_1],i1,i0,word,scale_x2
-			UML_DSHR(block, I0, I0, 16);								// dshr    i0,i0,16
-			UML_DSTORE(block, block0, I1, I0, SIZE_WORD, SCALE_x2);		// dstore  [block0],i1,i0,word,scale_x2
-			UML_MOV(block, mem(&m_core->force_recompile), 1);
-			UML_RET(block);												// ret
+		{
+			code_label label_skip = label++;
+			code_label label_none = label++;
 
-			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
 			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-
-			// 0x28000  ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff (block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff)
+			UML_JMPc(block, COND_A, label_none);						// ja      none
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_pm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[pm_pages],i2,dword,scale_x4
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label_none);						// jae     none
+
+			// 0x20000 ... 0x3ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
 			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_DSTORE(block, block1_2, I1, I0, SIZE_WORD, SCALE_x2);	// dstore  [block1_2],i1,i0,word,scale_x2
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+
+			// invalidate the translated code this word holds, if any
+			UML_MOV(block, I2, I1);										// mov     i2,i1
+			generate_code_write_check(block, label_skip, 1);
+			UML_SHR(block, I2, I1, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i1,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_ADD(block, I2, I1, 2);									// add     i2,i1,2
+			UML_SHR(block, I2, I2, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i2,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_DSTORE(block, ram_2, I1, I0, SIZE_WORD, SCALE_x2);		// dstore  [ram_2],i1,i0,word,scale_x2
+			UML_ADD(block, I2, I1, 2);									// add     i2,i1,2
+			UML_XOR(block, I2, I2, SHARC_IRAM32_HALF_XOR);				// xor     i2,i2,SHARC_IRAM32_HALF_XOR
+			UML_DSTORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// dstore  [ram32_16],i2,i0,word,scale_x2
 			UML_DSHR(block, I0, I0, 16);								// dshr    i0,i0,16
-			UML_DSTORE(block, block1_1, I1, I0, SIZE_WORD, SCALE_x2);	// dstore  [block1_1],i1,i0,word,scale_x2
+			UML_DSTORE(block, ram_1, I1, I0, SIZE_WORD, SCALE_x2);		// dstore  [ram_1],i1,i0,word,scale_x2
+			UML_ADD(block, I2, I1, 1);									// add     i2,i1,1
+			UML_XOR(block, I2, I2, SHARC_IRAM32_HALF_XOR);				// xor     i2,i2,SHARC_IRAM32_HALF_XOR
+			UML_DSTORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// dstore  [ram32_16],i2,i0,word,scale_x2
 			UML_DSHR(block, I0, I0, 16);								// dshr    i0,i0,16
-			UML_DSTORE(block, block1, I1, I0, SIZE_WORD, SCALE_x2);		// dstore  [block1],i1,i0,word,scale_x2		
+			UML_DSTORE(block, ram, I1, I0, SIZE_WORD, SCALE_x2);		// dstore  [ram],i1,i0,word,scale_x2
+			UML_XOR(block, I2, I1, SHARC_IRAM32_HALF_XOR);				// xor     i2,i1,SHARC_IRAM32_HALF_XOR
+			UML_DSTORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// dstore  [ram32_16],i2,i0,word,scale_x2
 			UML_RET(block);												// ret
 
-			UML_LABEL(block, label++);									// label2:
+			UML_LABEL(block, label_none);								// none:
 			break;
+		}
 
 		case MEM_ACCESSOR_PM_READ32:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label1
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
+			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
 			UML_JMPc(block, COND_A, label);								// ja      label1
-			
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_pm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[pm_pages],i2,dword,scale_x4
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label);							// jae     label1
+
+			// 0x20000 ... 0x3ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
 			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_LOAD(block, I0, block0, I1, SIZE_WORD, SCALE_x2);		// load    i0,[block0],i1,word,scale_x2
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+			UML_LOAD(block, I0, ram, I1, SIZE_WORD, SCALE_x2);			// load    i0,[ram],i1,word,scale_x2
 			UML_SHL(block, I0, I0, 16);									// shl     i0,i0,16
-			UML_LOAD(block, I2, block0_1, I1, SIZE_WORD, SCALE_x2);		// load    i2,[block0_1],i1,word,scale_x2
+			UML_LOAD(block, I2, ram_1, I1, SIZE_WORD, SCALE_x2);		// load    i2,[ram_1],i1,word,scale_x2
 			UML_OR(block, I0, I0, I2);									// or      i0,i0,i2
 			UML_RET(block);												// ret
 
 			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
-			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-
-			// 0x28000  ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff (block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff)
-			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_LOAD(block, I0, block1, I1, SIZE_WORD, SCALE_x2);		// load    i0,[block1],i1,word,scale_x2
-			UML_SHL(block, I0, I0, 16);									// shl     i0,i0,16
-			UML_LOAD(block, I2, block1_1, I1, SIZE_WORD, SCALE_x2);		// load    i2,[block1_1],i1,word,scale_x2			
-			UML_OR(block, I0, I0, I2);									// or      i0,i0,i2
-			UML_RET(block);												// ret
-
-			UML_LABEL(block, label++);									// label2:
 			break;
 
 		case MEM_ACCESSOR_PM_WRITE32:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label1
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
+			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
 			UML_JMPc(block, COND_A, label);								// ja      label1
-
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_pm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[pm_pages],i2,dword,scale_x4
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label);							// jae     label1
+
+			// 0x20000 ... 0x3ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
 			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_STORE(block, block0_1, I1, I0, SIZE_WORD, SCALE_x2);	// store   [block0_1],i1,i0,word,scale_x2
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+
+			// invalidate translated code at this halfword, if there is any
+			UML_MOV(block, I2, I1);										// mov     i2,i1
+			generate_code_write_check(block, label++, 1);
+
+			UML_SHR(block, I2, I1, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i1,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_ADD(block, I2, I1, 1);									// add     i2,i1,1
+			UML_SHR(block, I2, I2, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i2,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_STORE(block, ram_1, I1, I0, SIZE_WORD, SCALE_x2);		// store   [ram_1],i1,i0,word,scale_x2
+			UML_ADD(block, I2, I1, 1);									// add     i2,i1,1
+			UML_XOR(block, I2, I2, SHARC_IRAM32_HALF_XOR);				// xor     i2,i2,SHARC_IRAM32_HALF_XOR
+			UML_STORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// store   [ram32_16],i2,i0,word,scale_x2
 			UML_SHR(block, I0, I0, 16);									// shr     i0,i0,16
-			UML_STORE(block, block0, I1, I0, SIZE_WORD, SCALE_x2);		// store   [block0],i1,i0,word,scale_x2
+			UML_STORE(block, ram, I1, I0, SIZE_WORD, SCALE_x2);			// store   [ram],i1,i0,word,scale_x2
+			UML_XOR(block, I2, I1, SHARC_IRAM32_HALF_XOR);				// xor     i2,i1,SHARC_IRAM32_HALF_XOR
+			UML_STORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// store   [ram32_16],i2,i0,word,scale_x2
 			UML_RET(block);												// ret
 
 			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
-			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-
-			// 0x28000  ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff (block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff)
-			UML_MULS(block, I1, I1, I1, 3);								// muls    i1,3
-			UML_STORE(block, block1_1, I1, I0, SIZE_WORD, SCALE_x2);	// store   [block1_1],i1,i0,word,scale_x2
-			UML_SHR(block, I0, I0, 16);									// shr     i0,i0,16
-			UML_STORE(block, block1, I1, I0, SIZE_WORD, SCALE_x2);		// store   [block1],i1,i0,word,scale_x2
-			UML_RET(block);												// ret
-
-			UML_LABEL(block, label++);									// label2:
 			break;
 
 		case MEM_ACCESSOR_DM_READ32:
+		{
+			code_label label_short = label++;
+			code_label label_zero_extend = label++;
+			code_label label_iop = label++;
+			code_label label_none = label++;
+			code_label label_iram = label++;
+
 			UML_CMP(block, I1, IRAM_END);								// cmp     i1,IRAM_END
-			UML_JMPc(block, COND_BE, label);							// jbe     label1
+			UML_JMPc(block, COND_BE, label_iram);						// jbe     iram
 			// 0x80000 ...
+			for (int ramnum = 0; ramnum < m_fastram_select; ramnum++)
+			{
+				UINT32 *fastbase = m_fastram[ramnum].base - m_fastram[ramnum].start;
+				code_label label_next = label++;
+
+				UML_CMP(block, I1, m_fastram[ramnum].start);			// cmp     i1,fastram_start
+				UML_JMPc(block, COND_B, label_next);					// jb      next
+				UML_CMP(block, I1, m_fastram[ramnum].end);				// cmp     i1,fastram_end
+				UML_JMPc(block, COND_A, label_next);					// ja      next
+				UML_LOAD(block, I0, fastbase, I1, SIZE_DWORD, SCALE_x4);	// load    i0,[fastbase],i1,dword,scale_x4
+				UML_RET(block);											// ret
+				UML_LABEL(block, label_next);							// next:
+			}
 			UML_SHL(block, I1, I1, 2);									// shl     i1,i1,2
 			UML_READ(block, I0, I1, SIZE_DWORD, SPACE_DATA);			// read    i0,i1,dword,SPACE_DATA
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
-			UML_LOAD(block, I0, block0, I1, SIZE_WORD, SCALE_x4);		// load    i0,[block0],i1,word,scale_x4
-			UML_SHL(block, I0, I0, 16);									// shl     i0,i0,16
-			UML_LOAD(block, I2, block0_1, I1, SIZE_WORD, SCALE_x4);		// load    i2,[block0_1],i1,word,scale_x4
-			UML_OR(block, I0, I0, I2);									// or      i0,i0,i2
-			UML_RET(block);
-
-			UML_LABEL(block, label++);									// label2:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label3
-			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label3
-			// 0x28000 ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
-			UML_LOAD(block, I0, block1, I1, SIZE_WORD, SCALE_x4);		// load    i0,[block1],i1,word,scale_x4
-			UML_SHL(block, I0, I0, 16);									// shl     i0,i0,16
-			UML_LOAD(block, I2, block1_1, I1, SIZE_WORD, SCALE_x4);		// load    i2,[block1_1],i1,word,scale_x4
-			UML_OR(block, I0, I0, I2);									// or      i0,i0,i2
-			UML_RET(block);
-
-			UML_LABEL(block, label++);									// Label3:
-			UML_CMP(block, I1, IOP_REGISTER_END);						// cmp     i1,IOP_REGISTER_END
-			UML_JMPc(block, COND_A, label);								// ja      label4
-			// IOP registers
-			UML_MOV(block, mem(&m_core->arg0), I1);						// mov     [m_core->arg0],i1
-			UML_CALLC(block, cfunc_read_iop, this);						// callc   cfunc_read_iop
-			UML_MOV(block, I0, mem(&m_core->arg1));						// mov     i0,[m_core->arg1]
+			UML_LABEL(block, label_iram);								// iram:
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_dm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[dm_pages],i2,dword,scale_x4
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
+			UML_CMP(block, I2, MEM_PAGE_SHORT);							// cmp     i2,MEM_PAGE_SHORT
+			UML_JMPc(block, COND_AE, label_short);						// jae     short
+			// 0x20000 ... 0x3ffff
+			UML_SHL(block, I1, I1, 1);									// shl     i1,i1,1
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+			UML_LOAD(block, I0, ram32, I1, SIZE_DWORD, SCALE_x2);		// load    i0,[ram32],i1,dword,scale_x2
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label4:
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK0_START);				// cmp     i1,IRAM_SHORT_BLOCK0_START
-			UML_JMPc(block, COND_B, label+1);							// jb      label6
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK0_END);					// cmp     i1,IRAM_SHORT_BLOCK0_END
-			UML_JMPc(block, COND_A, label+1);							// ja      label6
-			// 0x40000 ... 0x4ffff
-			UML_AND(block, I1, I1, 0xffff);								// and     i1,i1,0xffff
+			UML_LABEL(block, label_short);								// short:
+			UML_CMP(block, I2, MEM_PAGE_IOP);							// cmp     i2,MEM_PAGE_IOP
+			UML_JMPc(block, COND_AE, label_iop);						// jae     iop
+			// 0x40000 ... 0x7ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
 			UML_XOR(block, I1, I1, 1);									// xor     i1,i1,1
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
 			UML_TEST(block, mem(&m_core->mode1), 0x4000);				// test    [m_core->mode1],0x4000
-			UML_JMPc(block, COND_Z, label);								// jz      label5
-			UML_LOADS(block, I0, block0, I1, SIZE_WORD, SCALE_x2);		// loads   i0,[block0],i1,word,scale_x2
+			UML_JMPc(block, COND_Z, label_zero_extend);					// jz      zero_extend
+			UML_LOADS(block, I0, ram, I1, SIZE_WORD, SCALE_x2);			// loads   i0,[ram],i1,word,scale_x2
 			UML_RET(block);
-			UML_LABEL(block, label++);									// label5:
-			UML_LOAD(block, I0, block0, I1, SIZE_WORD, SCALE_x2);		// load    i0,[block0],i1,word,scale_x2
+			UML_LABEL(block, label_zero_extend);						// zero_extend:
+			UML_LOAD(block, I0, ram, I1, SIZE_WORD, SCALE_x2);			// load    i0,[ram],i1,word,scale_x2
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label6:
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK1_START);				// cmp     i1,IRAM_SHORT_BLOCK1_START
-			UML_JMPc(block, COND_B, label+1);							// jb      label8
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK1_END);					// cmp     i1,IRAM_SHORT_BLOCK1_END
-			UML_JMPc(block, COND_A, label+1);							// ja      label8
-			// 0x50000 ... 0x7ffff
-			UML_AND(block, I1, I1, 0xffff);								// and     i1,i1,0xffff
-			UML_XOR(block, I1, I1, 1);									// xor     i1,i1,1
-			UML_TEST(block, mem(&m_core->mode1), 0x4000);				// test    [m_core->mode1],0x4000
-			UML_JMPc(block, COND_Z, label);								// jz      label7
-			UML_LOADS(block, I0, block1, I1, SIZE_WORD, SCALE_x2);		// loads   i0,[block1],i1,word,scale_x2
-			UML_RET(block);
-			UML_LABEL(block, label++);									// label7:
-			UML_LOAD(block, I0, block1, I1, SIZE_WORD, SCALE_x2);		// load    i0,[block1],i1,word,scale_x2
+			UML_LABEL(block, label_iop);								// iop:
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label_none);						// jae     none
+			// IOP registers, the page offset is the register number
+			UML_MOV(block, mem(&m_core->arg0), I1);						// mov     [m_core->arg0],i1
+			UML_CALLC(block, cfunc_read_iop, this);						// callc   cfunc_read_iop
+			UML_MOV(block, I0, mem(&m_core->arg1));						// mov     i0,[m_core->arg1]
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label8:
+			UML_LABEL(block, label_none);								// none:
 			break;
+		}
 
 		case MEM_ACCESSOR_DM_WRITE32:
+		{
+			code_label label_short;
+			code_label label_iop;
+			code_label label_none;
+			code_label label_iram;
+
 #if WRITE_SNOOP
 			//UML_CMP(block, I1, 0x283eb);
 			UML_CMP(block, I1, 0x2400047);
@@ -583,71 +794,79 @@ void adsp21062_device::static_generate_memory_accessor(MEM_ACCESSOR_TYPE type, c
 			UML_LABEL(block, label++);
 #endif
 
+			label_short = label++;
+			label_iop = label++;
+			label_none = label++;
+			label_iram = label++;
 
 			UML_CMP(block, I1, IRAM_END);								// cmp     i1,IRAM_END
-			UML_JMPc(block, COND_BE, label);							// jbe     label1
+			UML_JMPc(block, COND_BE, label_iram);						// jbe     iram
 			// 0x80000 ...
+			for (int ramnum = 0; ramnum < m_fastram_select; ramnum++)
+			{
+				UINT32 *fastbase = m_fastram[ramnum].base - m_fastram[ramnum].start;
+				code_label label_next = label++;
+
+				UML_CMP(block, I1, m_fastram[ramnum].start);			// cmp     i1,fastram_start
+				UML_JMPc(block, COND_B, label_next);					// jb      next
+				UML_CMP(block, I1, m_fastram[ramnum].end);				// cmp     i1,fastram_end
+				UML_JMPc(block, COND_A, label_next);					// ja      next
+				if (!m_fastram[ramnum].readonly)
+					UML_STORE(block, fastbase, I1, I0, SIZE_DWORD, SCALE_x4);	// store   [fastbase],i1,i0,dword,scale_x4
+				UML_RET(block);											// ret
+				UML_LABEL(block, label_next);							// next:
+			}
 			UML_SHL(block, I1, I1, 2);									// shl     i1,i1,2
 			UML_WRITE(block, I1, I0, SIZE_DWORD, SPACE_DATA);			// write   i1,i0,dword,SPACE_DATA
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label1:
-			UML_CMP(block, I1, IRAM_BLOCK0_START);						// cmp     i1,IRAM_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label2
-			UML_CMP(block, I1, IRAM_BLOCK0_END);						// cmp     i1,IRAM_BLOCK0_END
-			UML_JMPc(block, COND_A, label);								// ja      label2
-			// 0x20000 ... 0x27fff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
-			UML_STORE(block, block0_1, I1, I0, SIZE_WORD, SCALE_x4);	// store   [block0_1],i1,i0,word,scale_x4
+			UML_LABEL(block, label_iram);								// iram:
+			UML_SHR(block, I2, I1, MEM_PAGE_SHIFT);						// shr     i2,i1,MEM_PAGE_SHIFT
+			UML_LOAD(block, I2, m_dm_pages, I2, SIZE_DWORD, SCALE_x4);	// load    i2,[dm_pages],i2,dword,scale_x4
+			UML_AND(block, I1, I1, MEM_PAGE_MASK);						// and     i1,i1,MEM_PAGE_MASK
+			UML_CMP(block, I2, MEM_PAGE_SHORT);							// cmp     i2,MEM_PAGE_SHORT
+			UML_JMPc(block, COND_AE, label_short);						// jae     short
+			// 0x20000 ... 0x3ffff
+			UML_SHL(block, I1, I1, 1);									// shl     i1,i1,1
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+			UML_MOV(block, I2, I1);										// mov     i2,i1
+			generate_code_write_check(block, label++, 2);
+			UML_SHR(block, I2, I1, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i1,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_STORE(block, ram32, I1, I0, SIZE_DWORD, SCALE_x2);		// store   [ram32],i1,i0,dword,scale_x2
+			UML_STORE(block, ram_1, I1, I0, SIZE_WORD, SCALE_x2);		// store   [ram_1],i1,i0,word,scale_x2
 			UML_SHR(block, I0, I0, 16);									// shr     i0,i0,16
-			UML_STORE(block, block0, I1, I0, SIZE_WORD, SCALE_x4);		// store   [block0],i1,i0,word,scale_x4
+			UML_STORE(block, ram, I1, I0, SIZE_WORD, SCALE_x2);			// store   [ram],i1,i0,word,scale_x2
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label2:
-			UML_CMP(block, I1, IRAM_BLOCK1_START);						// cmp     i1,IRAM_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label3
-			UML_CMP(block, I1, IRAM_BLOCK1_END);						// cmp     i1,IRAM_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label3
-			// 0x28000 ... 0x3ffff
-			UML_AND(block, I1, I1, 0x7fff);								// and     i1,i1,0x7fff
-			UML_STORE(block, block1_1, I1, I0, SIZE_WORD, SCALE_x4);	// store   [block1_1],i1,i0,word,scale_x4
-			UML_SHR(block, I0, I0, 16);									// shr     i0,i0,16
-			UML_STORE(block, block1, I1, I0, SIZE_WORD, SCALE_x4);		// store   [block1],i1,i0,word,scale_x4
+			UML_LABEL(block, label_short);								// short:
+			UML_CMP(block, I2, MEM_PAGE_IOP);							// cmp     i2,MEM_PAGE_IOP
+			UML_JMPc(block, COND_AE, label_iop);						// jae     iop
+			// 0x40000 ... 0x7ffff
+			UML_AND(block, I2, I2, MEM_PAGE_BASE_MASK);					// and     i2,i2,MEM_PAGE_BASE_MASK
+			UML_XOR(block, I1, I1, 1);									// xor     i1,i1,1
+			UML_ADD(block, I1, I1, I2);									// add     i1,i1,i2
+			UML_MOV(block, I2, I1);										// mov     i2,i1
+			generate_code_write_check(block, label++, 1);
+			UML_SHR(block, I2, I1, SHARC_IRAM48_PAGE_SHIFT);			// shr     i2,i1,SHARC_IRAM48_PAGE_SHIFT
+			UML_STORE(block, m_internal_ram48_dirty, I2, 1, SIZE_BYTE, SCALE_x1);	// store   [ram48_dirty],i2,1,byte,scale_x1
+			UML_STORE(block, ram, I1, I0, SIZE_WORD, SCALE_x2);			// store   [ram],i1,i0,word,scale_x2
+			UML_XOR(block, I2, I1, SHARC_IRAM32_HALF_XOR);				// xor     i2,i1,SHARC_IRAM32_HALF_XOR
+			UML_STORE(block, ram32_16, I2, I0, SIZE_WORD, SCALE_x2);	// store   [ram32_16],i2,i0,word,scale_x2
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// Label3:
-			UML_CMP(block, I1, IOP_REGISTER_END);						// cmp     i1,IOP_REGISTER_END
-			UML_JMPc(block, COND_A, label);								// ja      label4
-			// IOP registers
+			UML_LABEL(block, label_iop);								// iop:
+			UML_CMP(block, I2, MEM_PAGE_NONE);							// cmp     i2,MEM_PAGE_NONE
+			UML_JMPc(block, COND_AE, label_none);						// jae     none
+			// IOP registers, the page offset is the register number
 			UML_MOV(block, mem(&m_core->arg0), I1);						// mov     [m_core->arg0],i1
 			UML_MOV(block, mem(&m_core->arg1), I0);						// mov     [m_core->arg1],i0
 			UML_CALLC(block, cfunc_write_iop, this);					// callc   cfunc_write_iop
 			UML_RET(block);
 
-			UML_LABEL(block, label++);									// label4:
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK0_START);				// cmp     i1,IRAM_SHORT_BLOCK0_START
-			UML_JMPc(block, COND_B, label);								// jb      label5
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK0_END);					// cmp     i1,IRAM_SHORT_BLOCK0_END
-			UML_JMPc(block, COND_A, label);								// ja      label5
-			// 0x40000 ... 0x4ffff
-			UML_AND(block, I1, I1, 0xffff);								// and     i1,i1,0xffff
-			UML_XOR(block, I1, I1, 1);									// xor     i1,i1,1
-			UML_STORE(block, block0, I1, I0, SIZE_WORD, SCALE_x2);		// store   [block0],i1,i0,word,scale_x2
-			UML_RET(block);
-
-			UML_LABEL(block, label++);									// label5:
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK1_START);				// cmp     i1,IRAM_SHORT_BLOCK1_START
-			UML_JMPc(block, COND_B, label);								// jb      label6
-			UML_CMP(block, I1, IRAM_SHORT_BLOCK1_END);					// cmp     i1,IRAM_SHORT_BLOCK1_END
-			UML_JMPc(block, COND_A, label);								// ja      label6
-			// 0x50000 ... 0x7ffff
-			UML_AND(block, I1, I1, 0xffff);								// and     i1,i1,0xffff
-			UML_XOR(block, I1, I1, 1);									// xor     i1,i1,1
-			UML_STORE(block, block1, I1, I0, SIZE_WORD, SCALE_x2);		// store   [block1],i1,i0,word,scale_x2
-			UML_RET(block);
-
-			UML_LABEL(block, label++);									// label6:
+			UML_LABEL(block, label_none);								// none:
 			break;
+		}
 	}
 
 	UML_RET(block);
@@ -910,7 +1129,8 @@ void adsp21062_device::static_generate_exception(UINT8 exception, const char *na
 	UML_LABEL(block, label_nopush);											// label_nopush:
 	UML_SHL(block, I0, I3, 2);												// shl     i0,i3,2
 	UML_ADD(block, I0, I0, 0x20000);										// add     i0,0x20000
-	UML_HASHJMP(block, 0, I0, *m_nocode);									// hashjmp i0,m_nocode
+	generate_code_slot(block, I0);											// <i1 = slot of i0>
+	UML_HASHJMP(block, I1, I0, *m_nocode);									// hashjmp i1,i0,m_nocode
 
 	block->end();
 }
@@ -1088,7 +1308,88 @@ void adsp21062_device::static_generate_mode1_ops()
 	block->end();
 }
 
+void adsp21062_device::static_generate_astat_materialize()
+{
+	// Trashes I0, F0
+
+	code_label label = 1;
+	drcuml_block *block = m_drcuml->begin_block(64);
+
+	// add a global entry for this
+	alloc_handle(m_drcuml.get(), &m_astat_materialize, "astat_materialize");
+	UML_HANDLE(block, *m_astat_materialize);								// handle  *m_astat_materialize
+
+	UML_MOV(block, I0, mem(&m_core->astat_lazy_op));						// mov     i0,[astat_lazy_op]
+	UML_CMP(block, I0, ASTAT_LAZY_ADD);										// cmp     i0,ASTAT_LAZY_ADD
+	UML_JMPc(block, COND_NE, label);										// jne     label1
+	UML_ADD(block, I0, mem(&m_core->astat_lazy_x), mem(&m_core->astat_lazy_y));	// add     i0,[astat_lazy_x],[astat_lazy_y]
+	UML_SETc(block, COND_Z, ASTAT_AZ);										// setc    z,ASTAT_AZ
+	UML_SETc(block, COND_S, ASTAT_AN);										// setc    s,ASTAT_AN
+	UML_SETc(block, COND_V, ASTAT_AV);										// setc    v,ASTAT_AV
+	UML_SETc(block, COND_C, ASTAT_AC);										// setc    c,ASTAT_AC
+	UML_JMP(block, 5);														// jmp     label5
+
+	UML_LABEL(block, label++);												// label1:
+	UML_CMP(block, I0, ASTAT_LAZY_SUB);										// cmp     i0,ASTAT_LAZY_SUB
+	UML_JMPc(block, COND_NE, label);										// jne     label2
+	UML_SUB(block, I0, mem(&m_core->astat_lazy_x), mem(&m_core->astat_lazy_y));	// sub     i0,[astat_lazy_x],[astat_lazy_y]
+	UML_SETc(block, COND_Z, ASTAT_AZ);										// setc    z,ASTAT_AZ
+	UML_SETc(block, COND_S, ASTAT_AN);										// setc    s,ASTAT_AN
+	UML_SETc(block, COND_V, ASTAT_AV);										// setc    v,ASTAT_AV
+	UML_SETc(block, COND_C, ASTAT_AC);										// setc    c,ASTAT_AC
+	UML_JMP(block, 5);														// jmp     label5
+
+	UML_LABEL(block, label++);												// label2:
+	UML_CMP(block, I0, ASTAT_LAZY_LOGIC);									// cmp     i0,ASTAT_LAZY_LOGIC
+	UML_JMPc(block, COND_NE, label);										// jne     label3
+	UML_CMP(block, mem(&m_core->astat_lazy_x), 0);							// cmp     [astat_lazy_x],0
+	UML_SETc(block, COND_Z, ASTAT_AZ);										// setc    z,ASTAT_AZ
+	UML_SETc(block, COND_S, ASTAT_AN);										// setc    s,ASTAT_AN
+	UML_MOV(block, ASTAT_AV, 0);											// mov     ASTAT_AV,0
+	UML_MOV(block, ASTAT_AC, 0);											// mov     ASTAT_AC,0
+	UML_JMP(block, 5);														// jmp     label5
+
+	UML_LABEL(block, label++);												// label3:
+	UML_CMP(block, I0, ASTAT_LAZY_FLOAT);									// cmp     i0,ASTAT_LAZY_FLOAT
+	UML_JMPc(block, COND_NE, label);										// jne     label4
+	UML_FSCOPYI(block, F0, mem(&m_core->astat_lazy_x));						// fscopyi f0,[astat_lazy_x]
+	UML_FSCMP(block, F0, mem(&m_core->fp0));								// fscmp   f0,[fp0]
+	UML_SETc(block, COND_Z, ASTAT_AZ);										// setc    z,ASTAT_AZ
+	UML_SETc(block, COND_C, ASTAT_AN);										// setc    c,ASTAT_AN
+	UML_MOV(block, ASTAT_AV, 0);											// mov     ASTAT_AV,0
+	UML_MOV(block, ASTAT_AC, 0);											// mov     ASTAT_AC,0
+
+	UML_LABEL(block, label++);												// label4:
+	UML_LABEL(block, label++);												// label5:
+	UML_MOV(block, mem(&m_core->astat_lazy_op), ASTAT_LAZY_NONE);			// mov     [astat_lazy_op],ASTAT_LAZY_NONE
+	UML_RET(block);
+
+	block->end();
+}
+
+
+
+
+/*-------------------------------------------------
+add_fastram - register a range of external DM
+backed by host memory, start and end are word
+addresses
+-------------------------------------------------*/
 
+void adsp21062_device::add_fastram(offs_t start, offs_t end, bool readonly, void *base)
+{
+	if (m_fastram_select < ARRAY_LENGTH(m_fastram))
+	{
+		m_fastram[m_fastram_select].start = start;
+		m_fastram[m_fastram_select].end = end;
+		m_fastram[m_fastram_select].readonly = readonly;
+		m_fastram[m_fastram_select].base = (UINT32 *)base;
+		m_fastram_select++;
+
+		/* the accessors are regenerated with the new range */
+		m_cache_dirty = true;
+	}
+}
 
 
 void adsp21062_device::execute_run_drc()
@@ -1101,20 +1402,44 @@ void adsp21062_device::execute_run_drc()
 
 	/* reset the cache if dirty */
 	if (m_cache_dirty)
+	{
+		/* an interpreter left running by a reset or an engine switch hands the state over by itself */
+		wait_compile_block();
+		m_fallback_loops.clear();
+		memset(m_fallback_writes, 0, sizeof(m_fallback_writes));
 		flush_cache();
+	}
 
 	m_cache_dirty = false;
-	m_core->force_recompile = 0;
 
 	/* execute */
 	do
 	{
+		/* while a block is compiled in the background, the interpreter runs */
+		if (m_drc_fallback && !execute_fallback())
+			return;
+
+		/* an eviction on the worker is refilled here, where the RAM can be read */
+		if (m_cache_refill)
+		{
+			m_cache_refill = false;
+			refill_cache();
+		}
+
+		m_drc_state_dirty = true;
 		execute_result = drcuml->execute(*m_entry);
 
 		/* if we need to recompile, do it */
-		if (execute_result == EXECUTE_MISSING_CODE)
+		if (execute_result == EXECUTE_MISSING_CODE || execute_result == EXECUTE_HOT_BLOCK)
 		{
-			compile_block(m_core->pc);
+			/* the DAG state at the block entry picks the RAM windows to inline accesses for */
+			memcpy(&m_dag_hint[0], m_core->dag1.i, sizeof(m_core->dag1.i));
+			memcpy(&m_dag_hint[8], m_core->dag2.i, sizeof(m_core->dag2.i));
+
+			if (m_active_engine == SHARC_ENGINE_TIERED)
+				queue_compile_block(m_core->pc);
+			else
+				compile_block(m_core->pc);
 		}
 		else if (execute_result == EXECUTE_UNMAPPED_CODE)
 		{
@@ -1128,62 +1453,520 @@ void adsp21062_device::execute_run_drc()
 }
 
 
-void adsp21062_device::compile_block(offs_t pc)
+void *adsp21062_device::compile_block_worker(void *param, int threadid)
 {
-	compiler_state compiler = { 0 };
+	adsp21062_device *sharc = (adsp21062_device *)param;
 
-	const opcode_desc *seqhead, *seqlast;
-	const opcode_desc *desclist;
-	bool override = false;
+	/* a fatalerror can't leave the worker thread, it is reported once the interpreter looks for the block */
+	try
+	{
+		sharc->compile_block(sharc->m_compile_pc);
+	}
+	catch (...)
+	{
+		sharc->m_compile_error = std::current_exception();
+	}
+	sharc->m_compile_snapshot = false;
+	sharc->m_compile_busy.store(false, std::memory_order_release);
+	return nullptr;
+}
 
-	drcuml_block *block;
 
-	desclist = m_drcfe->describe_code(pc);
+/*-------------------------------------------------
+queue_compile_block - compile the block at pc on
+the worker and hand the CPU to the interpreter
+until it is done
+-------------------------------------------------*/
 
-	bool succeeded = false;
-	while (!succeeded)
+void adsp21062_device::queue_compile_block(UINT32 pc)
+{
+	if (!prepare_block(pc))
+		return;
+
+	/* the worker reads the code from a copy, and finds the versions of every page it may
+	   describe selected, so it touches nothing the interpreter writes */
+	m_compile_base = pc - std::min<UINT32>(pc, SHARC_COMPILE_BACKWARDS);
+	UINT32 last_page = ~0;
+	for (int i = 0; i < SHARC_COMPILE_SNAPSHOT; i++)
 	{
-		try
-		{
-			block = m_drcuml->begin_block(4096);
+		UINT32 page = sharc_frontend::code_page(m_compile_base + i);
+		if (page != last_page)
+			select_code_version(page);
+		last_page = page;
 
-			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
-			{
-				const opcode_desc *curdesc;
-				UINT32 nextpc;
+		m_compile_code[i] = read_ram48(m_compile_base + i, true);
+	}
+	m_compile_snapshot = true;
 
-				/* determine the last instruction in this sequence */
-				for (seqlast = seqhead; seqlast != nullptr; seqlast = seqlast->next())
-					if (seqlast->flags & OPFLAG_END_SEQUENCE)
-						break;
-				assert(seqlast != nullptr);
+	enter_fallback();
 
-				/* if we don't have a hash for this mode/pc, or if we are overriding all, add one */
-				if (override || m_drcuml->hash_exists(0, seqhead->pc))
-					UML_HASH(block, 0, seqhead->pc);                                        // hash    mode,pc
+	m_compile_pc = pc;
+	m_compile_busy.store(true, std::memory_order_release);
+	if (osd_work_item_queue(m_compile_queue, compile_block_worker, this, WORK_ITEM_FLAG_AUTO_RELEASE) == nullptr)
+		compile_block_worker(this, 0);
+}
 
-																							/* if we already have a hash, and this is the first sequence, assume that we */
-																							/* are recompiling due to being out of sync and allow future overrides */
-				else if (seqhead == desclist)
-				{
-					override = true;
-					UML_HASH(block, 0, seqhead->pc);                                        // hash    mode,pc
-				}
 
-				/* otherwise, redispatch to that fixed PC and skip the rest of the processing */
-				else
-				{
-					UML_LABEL(block, seqhead->pc | 0x80000000);                             // label   seqhead->pc
-					UML_HASHJMP(block, 0, seqhead->pc, *m_nocode);							// hashjmp <0>,seqhead->pc,nocode
-					continue;
-				}
+void adsp21062_device::wait_compile_block()
+{
+	/* the worker writes into the cache, nobody may touch it before it is done however long that takes */
+	if (m_compile_queue != nullptr)
+	{
+		while (!osd_work_queue_wait(m_compile_queue, osd_ticks_per_second() * 10))
+			;
+	}
+}
 
-				/* label this instruction, if it may be jumped to locally */
-				if (seqhead->flags & OPFLAG_IS_BRANCH_TARGET)
+
+/*-------------------------------------------------
+execute_fallback - run the interpreter until the
+background compile is done, returns false if
+the timeslice ran out first
+-------------------------------------------------*/
+
+bool adsp21062_device::execute_fallback()
+{
+	while (m_core->icount > 0)
+	{
+		if (!m_compile_busy.load(std::memory_order_acquire))
+		{
+			if (m_compile_error)
+			{
+				std::exception_ptr error = m_compile_error;
+				m_compile_error = nullptr;
+				std::rethrow_exception(error);
+			}
+			if (leave_fallback())
+				return true;
+		}
+
+		/* interrupts can't wait for the compile to finish */
+		if (m_core->irq_pending != 0)
+			check_interrupts();
+
+		execute_op();
+
+		/* the frontend only learns about loops from the code it describes */
+		UINT32 op = (m_core->opcode >> 40) & 0xff;
+		if (op >= 0x0c && op <= 0x0e && std::find(m_fallback_loops.begin(), m_fallback_loops.end(), m_core->pc) == m_fallback_loops.end())
+			m_fallback_loops.push_back(m_core->pc);
+
+		/* IDLE gives up the rest of the timeslice and moves on, the same as in compiled code */
+		if (m_core->idle)
+		{
+			CHANGE_PC(m_core->pc + 1);
+			m_core->icount = 0;
+		}
+	}
+	return false;
+}
+
+
+/*-------------------------------------------------
+enter_fallback - convert the recompiler state
+for the interpreter and let it run
+-------------------------------------------------*/
+
+void adsp21062_device::enter_fallback()
+{
+	/* the compiled code writes the internal RAM without telling the interpreter */
+	flush_predecode();
+
+	sync_fallback_state();
+	m_drc_fallback = true;
+}
+
+
+/*-------------------------------------------------
+sync_fallback_state - put the recompiler state
+in the interpreter's form, the recompiler can
+keep running from it
+-------------------------------------------------*/
+
+void adsp21062_device::sync_fallback_state()
+{
+	astat_drc_materialize();
+
+	UINT32 astat = astat_drc_pack(m_core->astat_drc) | (m_core->astat & (FLG0 | FLG1 | FLG2 | FLG3));
+	m_core->astat = astat;
+	for (int i = 0; i < 4; i++)
+		m_core->astat_ring[i] = astat;
+
+	/* the compiled code only keeps the loop stack */
+	UINT32 top = m_core->lastack[m_core->lstkp];
+	m_core->laddr.addr = top & 0xffffff;
+	m_core->laddr.code = (top >> 24) & 0x1f;
+	m_core->laddr.loop_type = (top >> 30) & 0x3;
+
+	/* a conditional loop close to its end is evaluated with the flags saved at the ASTAT check,
+	   they go in the slot the loop end reads, one or two instructions from now */
+	if (m_core->lstkp > 0 && m_core->laddr.loop_type == 0)
+	{
+		const UINT32 copied = AZ | AV | AN | AC | MN | MV | SV | SZ | BTF;
+		UINT32 checked = (astat_drc_pack(m_core->astat_delay_copy) & copied) | (astat & ~copied);
+		if (m_core->pc == m_core->laddr.addr)
+			m_core->astat_ring[(m_core->astat_ring_pos - 2) & 3] = checked;
+		else if (m_core->pc == m_core->laddr.addr - 1)
+			m_core->astat_ring[(m_core->astat_ring_pos - 1) & 3] = checked;
+	}
+
+	CHANGE_PC(m_core->pc);
+	m_drc_state_dirty = false;
+}
+
+
+/*-------------------------------------------------
+leave_fallback - hand the CPU back to the
+compiled code, returns false if the interpreter
+is in the middle of a branch or a delayed
+register write
+-------------------------------------------------*/
+
+bool adsp21062_device::leave_fallback()
+{
+	if (m_core->faddr != m_core->daddr + 1 || m_core->nfaddr != m_core->faddr + 1 || m_core->systemreg_latency_cycles > 0)
+		return false;
+
+	m_drc_fallback = false;
+
+	/* blocks compiled without the loops the interpreter set up are stale */
+	for (UINT32 pc : m_fallback_loops)
+	{
+		sharc_frontend::LOOP_DESCRIPTOR loop;
+		if (m_drcfe->add_do_loop(pc, loop))
+		{
+			invalidate_code_page(sharc_frontend::code_page(loop.start_pc));
+			invalidate_code_page(sharc_frontend::code_page(loop.end_pc));
+			if (loop.astat_check_pc != 0xffffffff)
+				invalidate_code_page(sharc_frontend::code_page(loop.astat_check_pc));
+		}
+	}
+	m_fallback_loops.clear();
+
+	/* and so are the blocks the interpreter has written over */
+	for (int page = 0; page < SHARC_CODE_PAGE_COUNT; page++)
+	{
+		if ((m_fallback_writes[page / 32] & (1 << (page % 32))) && m_drcfe->codemap()[page])
+			invalidate_code_page(page, true);
+	}
+	memset(m_fallback_writes, 0, sizeof(m_fallback_writes));
+
+	astat_drc_unpack(m_core->astat_drc, m_core->astat);
+	m_core->astat_lazy_op = ASTAT_LAZY_NONE;
+
+	/* the ASTAT check of a conditional loop close to its end has been done by the interpreter */
+	if (m_core->lstkp > 0 && m_core->laddr.loop_type == 0)
+	{
+		if (m_core->daddr == m_core->laddr.addr)
+			astat_drc_unpack(m_core->astat_delay_copy, m_core->astat_ring[(m_core->astat_ring_pos - 2) & 3]);
+		else if (m_core->daddr == m_core->laddr.addr - 1)
+			astat_drc_unpack(m_core->astat_delay_copy, m_core->astat_ring[(m_core->astat_ring_pos - 1) & 3]);
+	}
+
+	m_core->pc = m_core->daddr;
+	return true;
+}
+
+
+/*-------------------------------------------------
+astat_drc_materialize - write the flags of a
+deferred ALU operation to astat_drc, the same as
+the astat_materialize handler
+-------------------------------------------------*/
+
+void adsp21062_device::astat_drc_materialize()
+{
+	UINT32 x = m_core->astat_lazy_x;
+	UINT32 y = m_core->astat_lazy_y;
+	UINT32 r;
+
+	switch (m_core->astat_lazy_op)
+	{
+		case ASTAT_LAZY_ADD:
+			r = x + y;
+			m_core->astat_drc.az = (r == 0) ? 1 : 0;
+			m_core->astat_drc.an = r >> 31;
+			m_core->astat_drc.av = (~(x ^ y) & (x ^ r)) >> 31;
+			m_core->astat_drc.ac = (r < x) ? 1 : 0;
+			break;
+
+		case ASTAT_LAZY_SUB:
+			r = x - y;
+			m_core->astat_drc.az = (r == 0) ? 1 : 0;
+			m_core->astat_drc.an = r >> 31;
+			m_core->astat_drc.av = ((x ^ y) & (x ^ r)) >> 31;
+			m_core->astat_drc.ac = (x < y) ? 1 : 0;
+			break;
+
+		case ASTAT_LAZY_LOGIC:
+			m_core->astat_drc.az = (x == 0) ? 1 : 0;
+			m_core->astat_drc.an = x >> 31;
+			m_core->astat_drc.av = 0;
+			m_core->astat_drc.ac = 0;
+			break;
+
+		case ASTAT_LAZY_FLOAT:
+		{
+			// an unordered compare sets both, like fscmp
+			float f = u2f(x);
+			m_core->astat_drc.az = (f == 0.0f || std::isnan(f)) ? 1 : 0;
+			m_core->astat_drc.an = (f < 0.0f || std::isnan(f)) ? 1 : 0;
+			m_core->astat_drc.av = 0;
+			m_core->astat_drc.ac = 0;
+			break;
+		}
+	}
+
+	m_core->astat_lazy_op = ASTAT_LAZY_NONE;
+}
+
+
+UINT32 adsp21062_device::astat_drc_pack(const ASTAT_DRC &astat)
+{
+	return (astat.az << AZ_SHIFT) | (astat.av << AV_SHIFT) | (astat.an << AN_SHIFT) | (astat.ac << AC_SHIFT) |
+			(astat.as << AS_SHIFT) | (astat.ai << AI_SHIFT) | (astat.mn << MN_SHIFT) | (astat.mv << MV_SHIFT) |
+			(astat.mu << MU_SHIFT) | (astat.mi << MI_SHIFT) | (astat.af << AF_SHIFT) | (astat.sv << SV_SHIFT) |
+			(astat.sz << SZ_SHIFT) | (astat.ss << SS_SHIFT) | (astat.btf << BTF_SHIFT) | (astat.cacc << 24);
+}
+
+
+void adsp21062_device::astat_drc_unpack(ASTAT_DRC &astat, UINT32 data)
+{
+	astat.az = (data >> AZ_SHIFT) & 1;
+	astat.av = (data >> AV_SHIFT) & 1;
+	astat.an = (data >> AN_SHIFT) & 1;
+	astat.ac = (data >> AC_SHIFT) & 1;
+	astat.as = (data >> AS_SHIFT) & 1;
+	astat.ai = (data >> AI_SHIFT) & 1;
+	astat.mn = (data >> MN_SHIFT) & 1;
+	astat.mv = (data >> MV_SHIFT) & 1;
+	astat.mu = (data >> MU_SHIFT) & 1;
+	astat.mi = (data >> MI_SHIFT) & 1;
+	astat.af = (data >> AF_SHIFT) & 1;
+	astat.sv = (data >> SV_SHIFT) & 1;
+	astat.sz = (data >> SZ_SHIFT) & 1;
+	astat.ss = (data >> SS_SHIFT) & 1;
+	astat.btf = (data >> BTF_SHIFT) & 1;
+	astat.cacc = data >> 24;
+}
+
+
+/*-------------------------------------------------
+native_loop_end - return the end of a counter
+loop whose whole body is the start of this
+sequence, or nullptr
+-------------------------------------------------*/
+
+static const opcode_desc *native_loop_end(const opcode_desc *seqhead, const opcode_desc *seqlast)
+{
+	for (const opcode_desc *desc = seqhead; desc != seqlast->next(); desc = desc->next())
+	{
+		if (desc->userflags & (OP_USERFLAG_LOOP_STATE | OP_USERFLAG_COND_LOOP))
+			return nullptr;
+		if (desc->flags & (OPFLAG_COMPILER_UNMAPPED | OPFLAG_INVALID_OPCODE | OPFLAG_IS_UNCONDITIONAL_BRANCH))
+			return nullptr;
+
+		if (desc->userflags & OP_USERFLAG_COUNTER_LOOP)
+		{
+			if (desc->targetpc != seqhead->pc || desc->delayslots != 0 || desc->skipslots != 0)
+				return nullptr;
+			return desc;
+		}
+
+		if (desc->flags & OPFLAG_IS_CONDITIONAL_BRANCH)
+			return nullptr;
+	}
+	return nullptr;
+}
+
+
+/*-------------------------------------------------
+has_native_loop - check if any sequence in the
+block starts with a native loop
+-------------------------------------------------*/
+
+static bool has_native_loop(const opcode_desc *desclist)
+{
+	const opcode_desc *seqhead, *seqlast;
+
+	for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
+	{
+		for (seqlast = seqhead; seqlast->next() != nullptr; seqlast = seqlast->next())
+			if (seqlast->flags & OPFLAG_END_SEQUENCE)
+				break;
+
+		if (native_loop_end(seqhead, seqlast) != nullptr)
+			return true;
+	}
+	return false;
+}
+
+
+/*-------------------------------------------------
+is_sequence_head - check if pc starts one of
+the sequences in the block
+-------------------------------------------------*/
+
+static bool is_sequence_head(const opcode_desc *desclist, UINT32 pc)
+{
+	bool head = true;
+	for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		if (head && desc->pc == pc)
+			return true;
+		head = (desc->flags & OPFLAG_END_SEQUENCE) != 0;
+	}
+	return false;
+}
+
+
+/*-------------------------------------------------
+has_return_sites - check if the block has a
+dynamic jump and a call returning to one of its
+sequences, only then is it worth compiling with
+return sites
+-------------------------------------------------*/
+
+static bool has_return_sites(const opcode_desc *desclist)
+{
+	bool dynamic_jump = false;
+	bool return_site = false;
+	for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		if (desc->userflags & OP_USERFLAG_CALL)
+		{
+			UINT32 retpc = desc->pc + ((desc->delayslots > 0) ? 3 : 1);
+			if (is_sequence_head(desclist, retpc))
+				return_site = true;
+		}
+		else if ((desc->flags & (OPFLAG_IS_UNCONDITIONAL_BRANCH | OPFLAG_IS_CONDITIONAL_BRANCH)) && desc->targetpc == BRANCH_TARGET_DYNAMIC)
+			dynamic_jump = true;
+	}
+	return dynamic_jump && return_site;
+}
+
+void adsp21062_device::compile_block(offs_t pc)
+{
+	compiler_state compiler = { 0 };
+
+	const opcode_desc *seqhead, *seqlast;
+	const opcode_desc *desclist;
+	bool override = false;
+
+	/* the debugger wants to see every iteration */
+	bool native_loops = (machine().debug_flags & DEBUG_FLAG_ENABLED) == 0;
+
+	drcuml_block *block;
+
+	/* a background compile had this done on the emulation thread when it was queued */
+	if (!m_compile_snapshot && !prepare_block(pc))
+		return;
+
+	desclist = m_drcfe->describe_block(pc);
+	compiler.desclist = desclist;
+
+	/* the stamps and hash modes are taken from the versions of all pages the block covers,
+	   the worker finds them selected for the whole window already */
+	if (!m_compile_snapshot)
+	{
+		for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+		{
+			select_code_version(sharc_frontend::code_page(desc->physpc));
+			select_code_version(sharc_frontend::code_page(desc->physpc + desc->delayslots));
+		}
+	}
+
+	/* data writes only invalidate the code when they land on one of its instructions */
+	for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		for (UINT32 pc = desc->physpc; pc <= desc->physpc + desc->delayslots; pc++)
+		{
+			UINT32 offset = sharc_frontend::code_offset(pc);
+			UINT32 index = ((offset >> 15) << 16) + (offset & 0x7fff) * 3;
+			for (int i = 0; i < 3; i++)
+				m_code_halfwords[(index + i) / 32] |= 1 << ((index + i) % 32);
+		}
+	}
+
+	/* blocks that have been entered often enough are compiled with return sites, the others
+	   would come out the same and are never compiled again for it */
+	bool return_sites = has_return_sites(desclist);
+	compiler.return_sites = return_sites && m_block_hot[sharc_frontend::code_offset(pc)];
+
+	/* pick the registers to keep in UML registers for this block */
+	alloc_fast_iregs(desclist, native_loops && has_native_loop(desclist));
+
+	bool succeeded = false;
+	while (!succeeded)
+	{
+		try
+		{
+			block = m_drcuml->begin_block(4096);
+
+			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
+			{
+				const opcode_desc *curdesc;
+				UINT32 nextpc;
+
+				/* determine the last instruction in this sequence */
+				for (seqlast = seqhead; seqlast != nullptr; seqlast = seqlast->next())
+					if (seqlast->flags & OPFLAG_END_SEQUENCE)
+						break;
+				assert(seqlast != nullptr);
+
+				/* the sequence is hashed in the mode of its page's version */
+				UINT32 slot = m_core->codepage_slot[sharc_frontend::code_page(seqhead->pc)];
+
+				/* if we don't have a hash for this mode/pc, or if we are overriding all, add one */
+				if (override || m_drcuml->hash_exists(slot, seqhead->pc))
+					UML_HASH(block, slot, seqhead->pc);                                     // hash    mode,pc
+
+																							/* if we already have a hash, and this is the first sequence, assume that we */
+																							/* are recompiling due to being out of sync and allow future overrides */
+				else if (seqhead == desclist)
+				{
+					override = true;
+					UML_HASH(block, slot, seqhead->pc);                                     // hash    mode,pc
+				}
+
+				/* otherwise, redispatch to that fixed PC and skip the rest of the processing */
+				else
+				{
 					UML_LABEL(block, seqhead->pc | 0x80000000);                             // label   seqhead->pc
+					UML_HASHJMP(block, slot, seqhead->pc, *m_nocode);						// hashjmp <slot>,seqhead->pc,nocode
+					continue;
+				}
+
+				/* count the entries of the block, for the refill after an eviction and until it is due for return sites */
+				if (seqhead == desclist)
+					generate_block_counter(block, &compiler, seqhead, return_sites && !compiler.return_sites);
+
+				/* entering from outside the block, load the fast registers */
+				load_fast_iregs(block);                                                     // <load fastregs>
+
+				/* label every sequence, so that jumps from elsewhere in the block can stay local */
+				UML_LABEL(block, seqhead->pc | 0x80000000);                                 // label   seqhead->pc
+
+				/* we can get here from anywhere, the ALU flags may still be deferred */
+				compiler.astat_lazy = ASTAT_LAZY_UNKNOWN;
+
+				/* make sure the code we are about to run hasn't been overwritten */
+				generate_code_page_check(block, &compiler, seqhead, seqlast);
+
+				/* a counter loop making up the start of the sequence runs as a native loop */
+				curdesc = seqhead;
+				if (native_loops)
+				{
+					const opcode_desc *loopend = native_loop_end(seqhead, seqlast);
+					if (loopend != nullptr)
+					{
+						generate_native_loop(block, &compiler, seqhead, loopend);
+						curdesc = loopend->next();
+					}
+				}
 
 				/* iterate over instructions in the sequence and compile them */
-				for (curdesc = seqhead; curdesc != seqlast->next(); curdesc = curdesc->next())
+				for ( ; curdesc != seqlast->next(); curdesc = curdesc->next())
 					generate_sequence_instruction(block, &compiler, curdesc);
 
 				/* if we need to return to the start, do it */
@@ -1194,19 +1977,18 @@ void adsp21062_device::compile_block(offs_t pc)
 					nextpc = seqlast->pc + (seqlast->skipslots + 1);
 
 
-				// force recompilation at end of block, if needed
-				UML_CMP(block, mem(&m_core->force_recompile), 0);
-				UML_JMPc(block, COND_Z, compiler.labelnum);
-				UML_MOV(block, mem(&m_cache_dirty), 1);
-				UML_MOV(block, mem(&m_core->icount), 0);
-				UML_LABEL(block, compiler.labelnum++);
-
-
 				/* count off cycles and go there */
 				generate_update_cycles(block, &compiler, nextpc, TRUE);						// <subtract cycles>
 
 				if (seqlast->next() == nullptr || seqlast->next()->pc != nextpc)
-					UML_HASHJMP(block, 0, nextpc, *m_nocode);								// hashjmp <mode>,nextpc,nocode
+				{
+					if (is_sequence_head(desclist, nextpc))
+						UML_JMP(block, nextpc | 0x80000000);								// jmp     nextpc | 0x80000000
+					else
+						UML_HASHJMP(block, mem(&m_core->codepage_slot[sharc_frontend::code_page(nextpc)]), nextpc, *m_nocode);	// hashjmp [codepage_slot],nextpc,nocode
+				}
+				else if (m_num_fast_iregs > 0)
+					UML_JMP(block, nextpc | 0x80000000);									// jmp     nextpc | 0x80000000 (skip the register load)
 			}
 
 			block->end();
@@ -1214,9 +1996,338 @@ void adsp21062_device::compile_block(offs_t pc)
 		}
 		catch (drcuml_block::abort_compilation &)
 		{
-			flush_cache();
+			/* the static handlers must not see this block's register map */
+			reset_fast_iregs();
+			evict_cache();
+
+			alloc_fast_iregs(desclist, native_loops && has_native_loop(desclist));
 		}
 	}
+
+	reset_fast_iregs();
+
+	/* after an eviction, bring back what was in use, the worker leaves that to the emulation thread */
+	if (m_cache_refill && !m_compile_snapshot)
+	{
+		m_cache_refill = false;
+		refill_cache();
+	}
+}
+
+
+/*-------------------------------------------------
+prepare_block - the part of compiling a block
+that uses the RAM and the state shared with the
+interpreter, always done on the emulation
+thread, returns false if the block doesn't need
+to be compiled
+-------------------------------------------------*/
+
+bool adsp21062_device::prepare_block(UINT32 pc)
+{
+	/* code loaded again after being overwritten may still have its blocks in the cache */
+	UINT32 page = sharc_frontend::code_page(pc);
+	if (select_code_version(page) && m_drcuml->hash_exists(m_core->codepage_slot[page], pc))
+		return false;
+
+	/* precompile the entry points the profile knows for this page */
+	if (m_drc_profile)
+	{
+		apply_drc_profile(pc);
+		m_profile[page].compiled.push_back(pc);
+	}
+
+	/* the hot state outlives the decay of the counts */
+	UINT32 offset = sharc_frontend::code_offset(pc);
+	if (m_block_hits[offset] >= HOT_BLOCK_THRESHOLD)
+		m_block_hot[offset] = 1;
+
+	/* the refill compiles the block again at the address it was entered at */
+	m_block_aliases[offset] |= 1 << ((pc >> 15) & 3);
+	return true;
+}
+
+
+void adsp21062_device::invalidate_code_page(UINT32 page, bool overwritten)
+{
+	CODE_PAGE_VERSIONS &ver = m_code_versions[page];
+
+	/* overwritten contents may come back and use their blocks again, blocks that are stale themselves may not */
+	if (!overwritten)
+	{
+		for (int slot = 0; slot < SHARC_CODE_VERSIONS; slot++)
+			ver.valid[slot] = false;
+	}
+	ver.current = -1;
+
+	/* give the page a new stamp so that blocks compiled from this page fail their check and get recompiled */
+	m_core->codepage_stamp[page] = ++m_code_stamp_seq;
+	m_drcfe->clear_code_page(page);
+
+	/* the page may be loaded with code the profile knows about later */
+	m_profile[page].applied = false;
+	m_profile[page].compiled.clear();
+
+	/* whatever gets loaded here has to earn its return sites again */
+	memset(&m_block_hits[page << SHARC_CODE_PAGE_SHIFT], 0, sizeof(UINT32) << SHARC_CODE_PAGE_SHIFT);
+	memset(&m_block_hot[page << SHARC_CODE_PAGE_SHIFT], 0, 1 << SHARC_CODE_PAGE_SHIFT);
+	memset(&m_block_aliases[page << SHARC_CODE_PAGE_SHIFT], 0, 1 << SHARC_CODE_PAGE_SHIFT);
+
+	/* blocks that derived their flag liveness from this page are stale too */
+	UINT32 deps[SHARC_CODE_PAGE_COUNT / 32];
+	m_drcfe->pop_page_dependents(page, deps);
+	for (int dep = 0; dep < SHARC_CODE_PAGE_COUNT; dep++)
+	{
+		if (dep != (int)page && (deps[dep / 32] & (1 << (dep % 32))))
+			invalidate_code_page(dep);
+	}
+}
+
+
+/*-------------------------------------------------
+code_page_hash - FNV-1a hash of the contents
+of a code page
+-------------------------------------------------*/
+
+UINT64 adsp21062_device::code_page_hash(UINT32 page)
+{
+	const UINT32 page_words = 1 << SHARC_CODE_PAGE_SHIFT;
+	const UINT32 block1_page = 0x8000 >> SHARC_CODE_PAGE_SHIFT;
+
+	const UINT16 *ram = (page < block1_page) ? m_internal_ram_block0 : m_internal_ram_block1;
+
+	/* the last page of a block is short, it must not run into the next block */
+	UINT32 start = (page & (block1_page - 1)) * page_words * 3;
+	UINT32 end = std::min<UINT32>(start + page_words * 3, SHARC_IRAM48_WORDS * 3);
+
+	UINT64 hash = U64(0xcbf29ce484222325);
+	for (UINT32 i = start; i < end; i++)
+	{
+		hash ^= ram[i] & 0xff;
+		hash *= U64(0x100000001b3);
+		hash ^= ram[i] >> 8;
+		hash *= U64(0x100000001b3);
+	}
+	return hash;
+}
+
+
+/*-------------------------------------------------
+reset_code_versions - forget the contents code
+pages were compiled from, after the cache has
+been emptied
+-------------------------------------------------*/
+
+void adsp21062_device::reset_code_versions()
+{
+	for (int page = 0; page < SHARC_CODE_PAGE_COUNT; page++)
+	{
+		CODE_PAGE_VERSIONS &ver = m_code_versions[page];
+
+		ver.current = -1;
+		ver.next = 0;
+		for (int slot = 0; slot < SHARC_CODE_VERSIONS; slot++)
+			ver.valid[slot] = false;
+
+		m_core->codepage_slot[page] = 0;
+	}
+}
+
+
+/*-------------------------------------------------
+select_code_version - find the version matching
+the contents of a page overwritten since it was
+last compiled, returns true if the page had
+been compiled from the same contents before
+-------------------------------------------------*/
+
+bool adsp21062_device::select_code_version(UINT32 page)
+{
+	CODE_PAGE_VERSIONS &ver = m_code_versions[page];
+
+	if (ver.current >= 0)
+		return false;
+
+	UINT64 hash = code_page_hash(page);
+	for (int slot = 0; slot < SHARC_CODE_VERSIONS; slot++)
+	{
+		if (ver.valid[slot] && ver.hash[slot] == hash)
+		{
+			/* the blocks of that version pass their checks again, and writes have to find them */
+			ver.current = slot;
+			m_core->codepage_slot[page] = slot;
+			m_core->codepage_stamp[page] = ver.stamp[slot];
+			m_drcfe->set_code_page(page);
+			return true;
+		}
+	}
+
+	/* new contents, take a free slot or the one filled the longest ago */
+	int slot = ver.next;
+	for (int i = 0; i < SHARC_CODE_VERSIONS; i++)
+	{
+		if (!ver.valid[i])
+		{
+			slot = i;
+			break;
+		}
+	}
+	ver.next = (slot + 1) % SHARC_CODE_VERSIONS;
+
+	ver.valid[slot] = true;
+	ver.hash[slot] = hash;
+	ver.stamp[slot] = m_core->codepage_stamp[page];
+	ver.current = slot;
+	m_core->codepage_slot[page] = slot;
+	return false;
+}
+
+
+/*-------------------------------------------------
+apply_drc_profile - if the page holding pc
+matches the profile, restore its loop entries
+and compile all of its known entry points
+-------------------------------------------------*/
+
+void adsp21062_device::apply_drc_profile(UINT32 pc)
+{
+	UINT32 page = sharc_frontend::code_page(pc);
+	DRC_PROFILE_PAGE &prof = m_profile[page];
+
+	if (!prof.loaded || prof.applied)
+		return;
+	prof.applied = true;
+
+	if (code_page_hash(page) != prof.hash)
+		return;
+
+	for (auto &loop : prof.loops)
+	{
+		for (int type = sharc_frontend::LOOP_ENTRY_START; type <= sharc_frontend::LOOP_ENTRY_ASTAT_CHECK; type <<= 1)
+		{
+			if (loop.entrytype & type)
+				m_drcfe->add_loop_entry(loop.pc, type, loop.start_pc, loop.looptype, loop.condition);
+		}
+	}
+
+	/* the precompiled blocks must not push the code in use out of the cache, stop at the refill
+	   budget or at the first eviction, and leave any refill to the block that is being compiled */
+	UINT32 evictions = m_cache_evictions;
+	bool refilling = m_cache_refilling;
+	m_cache_refilling = true;
+	for (auto entry : prof.entries)
+	{
+		if ((size_t)(m_cache->top() - m_cache->base()) >= (size_t)m_cache_size * CACHE_REFILL_PERCENT / 100 || m_cache_evictions != evictions)
+			break;
+
+		if (entry != pc && !m_drcuml->hash_exists(m_core->codepage_slot[page], entry))
+			compile_block(entry);
+	}
+	m_cache_refilling = refilling;
+
+	if (m_cache_evictions != evictions && !refilling)
+		m_cache_refill = true;
+}
+
+
+/*-------------------------------------------------
+load_drc_profile - read the profile file
+written by a previous run
+-------------------------------------------------*/
+
+void adsp21062_device::load_drc_profile()
+{
+	emu_file file(machine().options().nvram_directory(), OPEN_FLAG_READ);
+	std::string name = string_format("%s" PATH_SEPARATOR "%s.drc", machine().basename(), basetag());
+	if (file.open(name.c_str()) != osd_file::error::NONE)
+		return;
+
+	UINT32 header[3];
+	if (file.read(header, sizeof(header)) != sizeof(header) ||
+		header[0] != DRC_PROFILE_MAGIC || header[1] != DRC_PROFILE_VERSION || header[2] > SHARC_CODE_PAGE_COUNT)
+		return;
+
+	for (UINT32 i = 0; i < header[2]; i++)
+	{
+		UINT32 pagehdr[5];		// page, hash lo, hash hi, num entries, num loops
+		if (file.read(pagehdr, sizeof(pagehdr)) != sizeof(pagehdr) || pagehdr[0] >= SHARC_CODE_PAGE_COUNT)
+			break;
+
+		DRC_PROFILE_PAGE &prof = m_profile[pagehdr[0]];
+		prof.hash = ((UINT64)(pagehdr[2]) << 32) | pagehdr[1];
+		prof.entries.resize(pagehdr[3]);
+		prof.loops.resize(pagehdr[4]);
+
+		if (file.read(prof.entries.data(), pagehdr[3] * sizeof(UINT32)) != pagehdr[3] * sizeof(UINT32) ||
+			file.read(prof.loops.data(), pagehdr[4] * sizeof(DRC_PROFILE_LOOP)) != pagehdr[4] * sizeof(DRC_PROFILE_LOOP))
+		{
+			prof.entries.clear();
+			prof.loops.clear();
+			break;
+		}
+
+		// drop anything that doesn't belong to this page
+		auto bad_pc = [&pagehdr](UINT32 pc) { return pc < 0x20000 || pc >= 0x40000 || sharc_frontend::code_page(pc) != pagehdr[0]; };
+		prof.entries.erase(std::remove_if(prof.entries.begin(), prof.entries.end(), bad_pc), prof.entries.end());
+		prof.loops.erase(std::remove_if(prof.loops.begin(), prof.loops.end(), [&bad_pc](const DRC_PROFILE_LOOP &loop) { return bad_pc(loop.pc); }), prof.loops.end());
+
+		prof.loaded = true;
+	}
+}
+
+
+/*-------------------------------------------------
+save_drc_profile - write the entry points and
+loop entries of every page compiled in this
+run
+-------------------------------------------------*/
+
+void adsp21062_device::save_drc_profile()
+{
+	std::vector<UINT32> pages;
+	for (int page = 0; page < SHARC_CODE_PAGE_COUNT; page++)
+		if (!m_profile[page].compiled.empty())
+			pages.push_back(page);
+
+	if (pages.empty())
+		return;
+
+	emu_file file(machine().options().nvram_directory(), OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	std::string name = string_format("%s" PATH_SEPARATOR "%s.drc", machine().basename(), basetag());
+	if (file.open(name.c_str()) != osd_file::error::NONE)
+		return;
+
+	UINT32 header[3] = { DRC_PROFILE_MAGIC, DRC_PROFILE_VERSION, (UINT32)pages.size() };
+	file.write(header, sizeof(header));
+
+	for (auto page : pages)
+	{
+		DRC_PROFILE_PAGE &prof = m_profile[page];
+
+		std::vector<UINT32> &entries = prof.compiled;
+		std::sort(entries.begin(), entries.end());
+		entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+		// only keep loops that are set up by a DO instruction in this same page, the rest
+		// depend on code elsewhere and are found again when the DO is described
+		std::vector<DRC_PROFILE_LOOP> loops;
+		const UINT32 page_words = 1 << SHARC_CODE_PAGE_SHIFT;
+		for (UINT32 pc = 0x20000 + page * page_words; pc < 0x20000 + (page + 1) * page_words; pc++)
+		{
+			const sharc_frontend::LOOP_ENTRY &entry = m_drcfe->get_loop_entry(pc);
+			if (entry.entrytype != 0 && sharc_frontend::code_page(entry.start_pc - 1) == page)
+			{
+				DRC_PROFILE_LOOP loop = { pc, entry.entrytype, entry.looptype, entry.condition, entry.start_pc };
+				loops.push_back(loop);
+			}
+		}
+
+		UINT64 hash = code_page_hash(page);
+		UINT32 pagehdr[5] = { page, (UINT32)hash, (UINT32)(hash >> 32), (UINT32)entries.size(), (UINT32)loops.size() };
+		file.write(pagehdr, sizeof(pagehdr));
+		file.write(entries.data(), entries.size() * sizeof(UINT32));
+		file.write(loops.data(), loops.size() * sizeof(DRC_PROFILE_LOOP));
+	}
 }
 
 
@@ -1227,6 +2338,80 @@ void adsp21062_device::flush_cache()
 
 	m_drcfe->flush();
 
+	/* nothing is left to revive */
+	reset_code_versions();
+	memset(m_code_halfwords, 0, sizeof(m_code_halfwords));
+
+	/* the loop map is gone, so profiled pages have to be applied again */
+	for (int page = 0; page < SHARC_CODE_PAGE_COUNT; page++)
+		m_profile[page].applied = false;
+
+	static_generate_handlers();
+}
+
+
+/*-------------------------------------------------
+evict_cache - the cache is full, drop the
+translated code but keep what the frontend knows
+about it, the most used blocks are compiled again
+once the current one is done
+-------------------------------------------------*/
+
+void adsp21062_device::evict_cache()
+{
+	m_drcuml->reset();
+	static_generate_handlers();
+
+	m_cache_evictions++;
+	if (!m_cache_refilling)
+		m_cache_refill = true;
+}
+
+
+/*-------------------------------------------------
+refill_cache - compile the blocks that were
+entered the most before an eviction, until the
+cache is filled to CACHE_REFILL_PERCENT
+-------------------------------------------------*/
+
+void adsp21062_device::refill_cache()
+{
+	const UINT32 count = SHARC_CODE_PAGE_COUNT << SHARC_CODE_PAGE_SHIFT;
+	UINT32 evictions = m_cache_evictions;
+
+	std::vector<UINT32> offsets;
+	for (UINT32 offset = 0; offset < count; offset++)
+	{
+		if (m_block_hits[offset] > 0)
+			offsets.push_back(offset);
+	}
+	std::sort(offsets.begin(), offsets.end(), [this](UINT32 a, UINT32 b) { return m_block_hits[a] > m_block_hits[b]; });
+
+	m_cache_refilling = true;
+	for (UINT32 offset : offsets)
+	{
+		/* stop when the budget is used up, or if the blocks don't even fit */
+		if ((size_t)(m_cache->top() - m_cache->base()) >= (size_t)m_cache_size * CACHE_REFILL_PERCENT / 100 || m_cache_evictions != evictions)
+			break;
+
+		for (int alias = 0; alias < 4; alias++)
+		{
+			UINT32 pc = 0x20000 + alias * 0x8000 + (offset & 0x7fff);
+			if ((m_block_aliases[offset] & (1 << alias)) && !m_drcuml->hash_exists(m_core->codepage_slot[sharc_frontend::code_page(pc)], pc))
+				compile_block(pc);
+		}
+	}
+	m_cache_refilling = false;
+
+	/* age the counts, blocks that have gone out of use lose their place in the next generation,
+	   blocks that were compiled with return sites keep them */
+	for (UINT32 offset = 0; offset < count; offset++)
+		m_block_hits[offset] /= 2;
+}
+
+
+void adsp21062_device::static_generate_handlers()
+{
 	try
 	{
 		// generate the entry point and out-of-cycles handlers
@@ -1242,6 +2427,7 @@ void adsp21062_device::flush_cache()
 		static_generate_push_status();
 		static_generate_pop_status();
 		static_generate_mode1_ops();
+		static_generate_astat_materialize();
 
 		// generate exception handlers
 		static_generate_exception(EXCEPTION_INTERRUPT, "exception_interrupt");
@@ -1295,7 +2481,8 @@ void adsp21062_device::static_generate_entry_point()
 	UML_LABEL(block, skip);
 
 	/* generate a hash jump via the current mode and PC */
-	UML_HASHJMP(block, 0, mem(&m_core->pc), *m_nocode);   // hashjmp <mode>,<pc>,nocode
+	generate_code_slot(block, mem(&m_core->pc));										// <i1 = slot of pc>
+	UML_HASHJMP(block, I1, mem(&m_core->pc), *m_nocode);								// hashjmp i1,<pc>,nocode
 
 	block->end();
 }
@@ -1358,7 +2545,9 @@ void adsp21062_device::generate_sequence_instruction(drcuml_block *block, compil
 	{
 		UML_MOV(block, mem(&m_core->pc), desc->pc);											// mov     [pc],desc->pc
 		save_fast_iregs(block);																// <save fastregs>
+		generate_astat_materialize(block, compiler);										// <materialize ASTAT>
 		UML_DEBUG(block, desc->pc);															// debug   desc->pc
+		load_fast_iregs(block);																// <load fastregs>
 	}
 
 	/* if we hit an unmapped address, fatal error */
@@ -1376,13 +2565,29 @@ void adsp21062_device::generate_sequence_instruction(drcuml_block *block, compil
 	/* unless this is a virtual no-op, it's a regular instruction */
 	if (!(desc->flags & OPFLAG_VIRTUAL_NOOP))
 	{
+		UINT32 lazy_in = desc->regin[0] & ASTAT_LAZY_FLAGS;
+		UINT32 lazy_out = desc->regout[0] & ASTAT_LAZY_FLAGS;
+		bool conditional = (desc->userflags & OP_USERFLAG_CONDITIONAL) != 0;
+
+		/* readers need the deferred ALU flags, and so do writers that may leave some of them alone */
+		if (lazy_in != 0 || (lazy_out != 0 && (lazy_out != ASTAT_LAZY_FLAGS || conditional)))
+			generate_astat_materialize(block, compiler);									// <materialize ASTAT>
+
 		/* compile the instruction */
+		compiler->astat_lazy_recorded = false;
 		if (!generate_opcode(block, compiler, desc))
 		{
 			UML_MOV(block, mem(&m_core->pc), desc->pc);										// mov     [pc],desc->pc			
 			UML_DMOV(block, mem(&m_core->arg64), desc->opptr.q[0]);							// dmov    [arg64],*desc->opptr.q
 			UML_CALLC(block, cfunc_unimplemented, this);									// callc   cfunc_unimplemented,ppc
 		}
+
+		/* all ALU flags were written out, anything still deferred is stale */
+		if (lazy_out == ASTAT_LAZY_FLAGS && !conditional && !compiler->astat_lazy_recorded && compiler->astat_lazy != ASTAT_LAZY_NONE)
+		{
+			UML_MOV(block, mem(&m_core->astat_lazy_op), ASTAT_LAZY_NONE);					// mov     [astat_lazy_op],ASTAT_LAZY_NONE
+			compiler->astat_lazy = ASTAT_LAZY_NONE;
+		}
 	}
 
 
@@ -1414,8 +2619,8 @@ void adsp21062_device::generate_sequence_instruction(drcuml_block *block, compil
 	}
 
 
-	// insert loop check at this instruction if needed	
-	if (desc->userflags & OP_USERFLAG_COUNTER_LOOP)
+	// insert loop check at this instruction if needed, native loops count iterations themselves
+	if ((desc->userflags & OP_USERFLAG_COUNTER_LOOP) && !compiler->native_loop)
 	{
 		code_label label_expire = compiler->labelnum++;
 		UML_MOV(block, I1, mem(&m_core->lstkp));							// mov     i1,[m_core->lstkp]
@@ -1450,6 +2655,9 @@ void adsp21062_device::generate_sequence_instruction(drcuml_block *block, compil
 	// copy ASTAT bits over for conditional loop
 	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY)
 	{
+		if (desc->userflags & (OP_USERFLAG_ASTAT_DELAY_COPY_AZ | OP_USERFLAG_ASTAT_DELAY_COPY_AN | OP_USERFLAG_ASTAT_DELAY_COPY_AV | OP_USERFLAG_ASTAT_DELAY_COPY_AC))
+			generate_astat_materialize(block, compiler);									// <materialize ASTAT>
+
 		if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AZ)
 			UML_MOV(block, mem(&m_core->astat_delay_copy.az), mem(&m_core->astat_drc.az));
 		if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AN)
@@ -1473,6 +2681,9 @@ void adsp21062_device::generate_sequence_instruction(drcuml_block *block, compil
 
 void adsp21062_device::generate_update_cycles(drcuml_block *block, compiler_state *compiler, uml::parameter param, int allow_exception)
 {
+	/* every caller is about to leave the sequence, write back the fast registers */
+	save_fast_iregs(block);																	// <save fastregs>
+
 	/* check full interrupts if pending */
 	if (compiler->checkints)
 	{
@@ -1506,6 +2717,129 @@ void adsp21062_device::generate_update_cycles(drcuml_block *block, compiler_stat
 	compiler->cycles = 0;
 }
 
+void adsp21062_device::generate_code_page_check(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, const opcode_desc *seqlast)
+{
+	UINT32 first_page = sharc_frontend::code_page(seqhead->physpc);
+	UINT32 last_page = sharc_frontend::code_page(seqlast->physpc + seqlast->delayslots);
+
+	/* a sequence spans at most two pages */
+	UML_CMP(block, mem(&m_core->codepage_stamp[first_page]), m_core->codepage_stamp[first_page]);	// cmp     [codepage_stamp],stamp
+	UML_EXHc(block, COND_NE, *m_nocode, seqhead->pc);												// exh     nocode,seqhead->pc
+	if (last_page != first_page)
+	{
+		UML_CMP(block, mem(&m_core->codepage_stamp[last_page]), m_core->codepage_stamp[last_page]);	// cmp     [codepage_stamp],stamp
+		UML_EXHc(block, COND_NE, *m_nocode, seqhead->pc);											// exh     nocode,seqhead->pc
+	}
+}
+
+void adsp21062_device::generate_native_loop(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, const opcode_desc *loopend)
+{
+	code_label skip = compiler->labelnum++;
+	code_label body = compiler->labelnum++;
+	code_label batch_done = compiler->labelnum++;
+	code_label expired = compiler->labelnum++;
+	const opcode_desc *desc;
+	int body_cycles = 0;
+	bool writes_memory = false;
+
+	for (desc = seqhead; desc != loopend->next(); desc = desc->next())
+	{
+		body_cycles += desc->cycles;
+		if (desc->flags & OPFLAG_WRITES_MEMORY)
+			writes_memory = true;
+	}
+
+	/* run as many iterations as the cycles left allow, but at least one */
+	UML_MOV(block, I0, 1);																	// mov     i0,1
+	UML_CMP(block, mem(&m_core->icount), body_cycles);										// cmp     [icount],body_cycles
+	UML_JMPc(block, COND_L, skip);															// jl      skip
+	UML_DIVU(block, I0, I0, mem(&m_core->icount), body_cycles);								// divu    i0,i0,[icount],body_cycles
+	UML_CMP(block, I0, CURLCNTR);															// cmp     i0,CURLCNTR
+	UML_MOVc(block, COND_A, I0, CURLCNTR);													// mova    i0,CURLCNTR
+	UML_CMP(block, I0, 0);																	// cmp     i0,0
+	UML_MOVc(block, COND_E, I0, 1);															// move    i0,1
+	UML_LABEL(block, skip);																	// skip:
+	UML_MOV(block, mem(&m_core->loop_batch), I0);											// mov     [loop_batch],i0
+	UML_MOV(block, m_loopreg, I0);															// mov     loopreg,i0
+
+	/* the body is entered from its own end, nothing is known about deferred flags there */
+	compiler->astat_lazy = ASTAT_LAZY_UNKNOWN;
+	UML_LABEL(block, body);																	// body:
+
+	compiler->native_loop = TRUE;
+	for (desc = seqhead; desc != loopend->next(); desc = desc->next())
+		generate_sequence_instruction(block, compiler, desc);
+	compiler->native_loop = FALSE;
+
+	/* the cycles are accounted for per batch */
+	compiler->cycles = 0;
+	UML_MAPVAR(block, MAPVAR_CYCLES, 0);													// mapvar  CYCLES,0
+
+	UML_SUB(block, m_loopreg, m_loopreg, 1);												// sub     loopreg,loopreg,1
+	if (writes_memory)
+	{
+		/* the body may have overwritten itself, leave the batch if so */
+		UINT32 first_page = sharc_frontend::code_page(seqhead->physpc);
+		UINT32 last_page = sharc_frontend::code_page(loopend->physpc);
+
+		UML_JMPc(block, COND_Z, batch_done);												// jz      batch_done
+		UML_CMP(block, mem(&m_core->codepage_stamp[first_page]), m_core->codepage_stamp[first_page]);	// cmp     [codepage_stamp],stamp
+		UML_JMPc(block, COND_NE, batch_done);												// jne     batch_done
+		if (last_page != first_page)
+		{
+			UML_CMP(block, mem(&m_core->codepage_stamp[last_page]), m_core->codepage_stamp[last_page]);	// cmp     [codepage_stamp],stamp
+			UML_JMPc(block, COND_NE, batch_done);											// jne     batch_done
+		}
+		UML_JMP(block, body);																// jmp     body
+	}
+	else
+		UML_JMPc(block, COND_NZ, body);														// jnz     body
+
+	/* write back the iterations run in this batch */
+	UML_LABEL(block, batch_done);															// batch_done:
+	UML_SUB(block, I0, mem(&m_core->loop_batch), m_loopreg);								// sub     i0,[loop_batch],loopreg
+	UML_SUB(block, CURLCNTR, CURLCNTR, I0);													// sub     CURLCNTR,CURLCNTR,i0
+	UML_MOV(block, I1, mem(&m_core->lstkp));												// mov     i1,[m_core->lstkp]
+	UML_LOAD(block, I2, m_core->lcstack, I1, SIZE_DWORD, SCALE_x4);							// load    i2,m_core->lcstack,i1,dword,scale_x4
+	UML_SUB(block, I2, I2, I0);																// sub     i2,i2,i0
+	UML_STORE(block, m_core->lcstack, I1, I2, SIZE_DWORD, SCALE_x4);						// store   m_core->lcstack,i1,i2,dword,scale_x4
+	UML_MULU(block, I0, I0, I0, body_cycles);												// mulu    i0,i0,i0,body_cycles
+	UML_SUB(block, mem(&m_core->icount), mem(&m_core->icount), I0);							// sub     [icount],[icount],i0
+	UML_CMP(block, CURLCNTR, 0);															// cmp     CURLCNTR,0
+	UML_JMPc(block, COND_E, expired);														// je      expired
+
+	/* not done yet, start another batch if there are cycles left, the page check at the
+	   start of the sequence may leave the block, so the fast registers are saved either way */
+	save_fast_iregs(block);																	// <save fastregs>
+	UML_CMP(block, mem(&m_core->icount), 0);												// cmp     [icount],0
+	UML_JMPc(block, COND_G, seqhead->pc | 0x80000000);										// jg      seqhead->pc | 0x80000000
+	UML_EXH(block, *m_out_of_cycles, seqhead->pc);											// exh     out_of_cycles,seqhead->pc
+
+	UML_LABEL(block, expired);																// expired:
+	UML_CALLH(block, *m_pop_pc);															// callh   m_pop_pc
+	UML_CALLH(block, *m_pop_loop);															// callh   m_pop_loop
+}
+
+
+void adsp21062_device::generate_block_counter(drcuml_block *block, compiler_state *compiler, const opcode_desc *seqhead, bool promote)
+{
+	UINT32 *hits = &m_block_hits[sharc_frontend::code_offset(seqhead->pc)];
+
+	UML_ADD(block, mem(hits), mem(hits), 1);												// add     [hits],[hits],1
+	if (!promote)
+		return;
+
+	code_label skip = compiler->labelnum++;
+	UML_CMP(block, mem(hits), HOT_BLOCK_THRESHOLD);											// cmp     [hits],HOT_BLOCK_THRESHOLD
+	UML_JMPc(block, COND_NE, skip);															// jmp     skip,NE
+
+	/* the fast registers are not loaded yet, recompile and come back through the hash table */
+	UML_MOV(block, mem(&m_core->pc), seqhead->pc);											// mov     [pc],seqhead->pc
+	UML_EXIT(block, EXECUTE_HOT_BLOCK);														// exit    EXECUTE_HOT_BLOCK
+
+	UML_LABEL(block, skip);																	// skip:
+}
+
 void adsp21062_device::generate_write_mode1_imm(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, UINT32 data)
 {
 	code_label skip;
@@ -1518,6 +2852,9 @@ void adsp21062_device::generate_write_mode1_imm(drcuml_block *block, compiler_st
 	if (data & 0x4)
 		fatalerror("generate_write_mode1_imm: tried to enable MR alternate");
 
+	// the swap handlers work on the registers in memory
+	save_fast_iregs(block);
+
 	// DAG1 regs 4-7
 	skip = compiler->labelnum++;
 	UML_TEST(block, MODE1, 0x8);
@@ -1561,6 +2898,8 @@ void adsp21062_device::generate_write_mode1_imm(drcuml_block *block, compiler_st
 	UML_LABEL(block, skip);
 
 	UML_MOV(block, MODE1, data);
+
+	load_fast_iregs(block);
 }
 
 void adsp21062_device::generate_set_mode1_imm(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, UINT32 data)
@@ -1571,6 +2910,11 @@ void adsp21062_device::generate_set_mode1_imm(drcuml_block *block, compiler_stat
 		fatalerror("generate_set_mode1_imm: tried to enable I0 bit reversing");
 	if (data & 0x4)
 		fatalerror("generate_set_mode1_imm: tried to enable MR alternate");
+
+	// the swap handlers work on the registers in memory
+	if (data & 0x4f8)
+		save_fast_iregs(block);
+
 	if (data & 0x8)		// DAG1 regs 4-7
 	{
 		code_label skip = compiler->labelnum++;
@@ -1621,6 +2965,9 @@ void adsp21062_device::generate_set_mode1_imm(drcuml_block *block, compiler_stat
 	}
 
 	UML_OR(block, MODE1, MODE1, data);
+
+	if (data & 0x4f8)
+		load_fast_iregs(block);
 }
 
 void adsp21062_device::generate_clear_mode1_imm(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, UINT32 data)
@@ -1631,6 +2978,11 @@ void adsp21062_device::generate_clear_mode1_imm(drcuml_block *block, compiler_st
 		fatalerror("generate_clear_mode1_imm: tried to disable I0 bit reversing");
 	if (data & 0x4)
 		fatalerror("generate_clear_mode1_imm: tried to disable MR alternate");
+
+	// the swap handlers work on the registers in memory
+	if (data & 0x4f8)
+		save_fast_iregs(block);
+
 	if (data & 0x8)		// DAG1 regs 4-7
 	{
 		code_label skip = compiler->labelnum++;
@@ -1681,9 +3033,171 @@ void adsp21062_device::generate_clear_mode1_imm(drcuml_block *block, compiler_st
 	}
 
 	UML_AND(block, MODE1, MODE1, ~data);
+
+	if (data & 0x4f8)
+		load_fast_iregs(block);
+}
+
+
+
+/*-------------------------------------------------
+iram_word_window - find the internal RAM block a
+DM|PM word address falls in, returning the first
+address of its window and the halfword offset of
+the block in m_internal_ram
+-------------------------------------------------*/
+
+static bool iram_word_window(UINT32 address, int g, UINT32 &start, UINT32 &base)
+{
+	if (address >= IRAM_BLOCK0_START && address <= IRAM_BLOCK0_END)
+	{
+		start = IRAM_BLOCK0_START;
+		base = 0;
+	}
+	else if (address >= IRAM_BLOCK1_START && address <= IRAM_BLOCK1_END)
+	{
+		start = address & ~0x7fff;		// block 1 is mirrored in 0x28000...2ffff, 0x30000...0x37fff and 0x38000...3ffff
+		base = 0x10000;
+	}
+	else
+	{
+		return false;
+	}
+
+	// PM words past the end of the block are left to the accessor
+	return address - start < (UINT32)(g ? IRAM_PM_WINDOW : IRAM_DM_WINDOW);
+}
+
+
+/*-------------------------------------------------
+generate_read_memory - read the DM|PM word at I1
+into I0, inline from the internal RAM block hint
+points to and through the accessor otherwise
+-------------------------------------------------*/
+
+void adsp21062_device::generate_read_memory(drcuml_block *block, compiler_state *compiler, int g, bool px48, UINT32 hint)
+{
+	uml::code_handle &accessor = px48 ? *m_pm_read48 : (g ? *m_pm_read32 : *m_dm_read32);
+	UINT32 start, base;
+
+	if (!iram_word_window(hint, g, start, base))
+	{
+		UML_CALLH(block, accessor);										// callh   dm|pm_read
+		return;
+	}
+
+	code_label label_slow = compiler->labelnum++;
+	code_label label_done = compiler->labelnum++;
+	UINT16 *ram = &m_internal_ram[base];
+
+	UML_SUB(block, I2, I1, start);										// sub     i2,i1,start
+	UML_CMP(block, I2, g ? IRAM_PM_WINDOW : IRAM_DM_WINDOW);			// cmp     i2,window
+	UML_JMPc(block, COND_AE, label_slow);								// jae     slow
+	if (px48)
+	{
+		UML_MULS(block, I2, I2, I2, 3);									// muls    i2,3
+		UML_DLOAD(block, I0, &ram[0], I2, SIZE_WORD, SCALE_x2);			// dload   i0,[ram],i2,word,scale_x2
+		UML_DSHL(block, I0, I0, 32);									// dshl    i0,i0,32
+		UML_DLOAD(block, I1, &ram[1], I2, SIZE_WORD, SCALE_x2);			// dload   i1,[ram_1],i2,word,scale_x2
+		UML_DSHL(block, I1, I1, 16);									// dshl    i1,i1,16
+		UML_DOR(block, I0, I0, I1);										// dor     i0,i0,i1
+		UML_DLOAD(block, I1, &ram[2], I2, SIZE_WORD, SCALE_x2);			// dload   i1,[ram_2],i2,word,scale_x2
+		UML_DOR(block, I0, I0, I1);										// dor     i0,i0,i1
+	}
+	else if (g)
+	{
+		UML_MULS(block, I2, I2, I2, 3);									// muls    i2,3
+		UML_LOAD(block, I0, &ram[0], I2, SIZE_WORD, SCALE_x2);			// load    i0,[ram],i2,word,scale_x2
+		UML_SHL(block, I0, I0, 16);										// shl     i0,i0,16
+		UML_LOAD(block, I1, &ram[1], I2, SIZE_WORD, SCALE_x2);			// load    i1,[ram_1],i2,word,scale_x2
+		UML_OR(block, I0, I0, I1);										// or      i0,i0,i1
+	}
+	else
+	{
+		UML_LOAD(block, I0, &m_internal_ram32[base >> 1], I2, SIZE_DWORD, SCALE_x4);	// load    i0,[ram32],i2,dword,scale_x4
+	}
+	UML_JMP(block, label_done);											// jmp     done
+
+	UML_LABEL(block, label_slow);										// slow:
+	UML_CALLH(block, accessor);											// callh   dm|pm_read
+	UML_LABEL(block, label_done);										// done:
 }
 
 
+/*-------------------------------------------------
+generate_write_memory - write I0 to the DM|PM
+word at I1, inline to the internal RAM block hint
+points to and through the accessor otherwise
+-------------------------------------------------*/
+
+void adsp21062_device::generate_write_memory(drcuml_block *block, compiler_state *compiler, int g, bool px48, UINT32 hint)
+{
+	uml::code_handle &accessor = px48 ? *m_pm_write48 : (g ? *m_pm_write32 : *m_dm_write32);
+	UINT32 start, base;
+
+	// 48-bit writes may land on translated code, leave the invalidation to the accessor
+	if (px48 || WRITE_SNOOP || !iram_word_window(hint, g, start, base))
+	{
+		UML_CALLH(block, accessor);										// callh   dm|pm_write
+		return;
+	}
+
+	code_label label_slow = compiler->labelnum++;
+	code_label label_done = compiler->labelnum++;
+	UINT16 *ram = &m_internal_ram[base];
+	UINT8 *dirty = &m_internal_ram48_dirty[base >> SHARC_IRAM48_PAGE_SHIFT];
+	UINT16 *ram32_16 = &reinterpret_cast<UINT16 *>(m_internal_ram32)[base];
+
+	UML_SUB(block, I2, I1, start);										// sub     i2,i1,start
+	UML_CMP(block, I2, g ? IRAM_PM_WINDOW : IRAM_DM_WINDOW);			// cmp     i2,window
+	UML_JMPc(block, COND_AE, label_slow);								// jae     slow
+	if (g)
+	{
+		UML_MULS(block, I2, I2, I2, 3);									// muls    i2,3
+
+		// invalidate translated code at this halfword, if there is any
+		UML_MOV(block, I1, I2);											// mov     i1,i2
+		UML_ADD(block, I2, I2, base);									// add     i2,i2,base
+		generate_code_write_check(block, compiler->labelnum++, 1);
+		UML_MOV(block, I2, I1);											// mov     i2,i1
+
+		UML_SHR(block, I1, I2, SHARC_IRAM48_PAGE_SHIFT);				// shr     i1,i2,SHARC_IRAM48_PAGE_SHIFT
+		UML_STORE(block, dirty, I1, 1, SIZE_BYTE, SCALE_x1);			// store   [ram48_dirty],i1,1,byte,scale_x1
+		UML_ADD(block, I1, I2, 1);										// add     i1,i2,1
+		UML_SHR(block, I1, I1, SHARC_IRAM48_PAGE_SHIFT);				// shr     i1,i1,SHARC_IRAM48_PAGE_SHIFT
+		UML_STORE(block, dirty, I1, 1, SIZE_BYTE, SCALE_x1);			// store   [ram48_dirty],i1,1,byte,scale_x1
+		UML_STORE(block, &ram[1], I2, I0, SIZE_WORD, SCALE_x2);			// store   [ram_1],i2,i0,word,scale_x2
+		UML_ADD(block, I1, I2, 1);										// add     i1,i2,1
+		UML_XOR(block, I1, I1, SHARC_IRAM32_HALF_XOR);					// xor     i1,i1,SHARC_IRAM32_HALF_XOR
+		UML_STORE(block, ram32_16, I1, I0, SIZE_WORD, SCALE_x2);		// store   [ram32_16],i1,i0,word,scale_x2
+		UML_SHR(block, I0, I0, 16);										// shr     i0,i0,16
+		UML_STORE(block, &ram[0], I2, I0, SIZE_WORD, SCALE_x2);			// store   [ram],i2,i0,word,scale_x2
+		UML_XOR(block, I1, I2, SHARC_IRAM32_HALF_XOR);					// xor     i1,i2,SHARC_IRAM32_HALF_XOR
+		UML_STORE(block, ram32_16, I1, I0, SIZE_WORD, SCALE_x2);		// store   [ram32_16],i1,i0,word,scale_x2
+	}
+	else
+	{
+		// invalidate translated code at these halfwords, if there is any
+		UML_MOV(block, I1, I2);											// mov     i1,i2
+		UML_SHL(block, I2, I2, 1);										// shl     i2,i2,1
+		UML_ADD(block, I2, I2, base);									// add     i2,i2,base
+		generate_code_write_check(block, compiler->labelnum++, 2);
+		UML_MOV(block, I2, I1);											// mov     i2,i1
+
+		UML_SHR(block, I1, I2, SHARC_IRAM48_PAGE_SHIFT - 1);			// shr     i1,i2,SHARC_IRAM48_PAGE_SHIFT-1
+		UML_STORE(block, dirty, I1, 1, SIZE_BYTE, SCALE_x1);			// store   [ram48_dirty],i1,1,byte,scale_x1
+		UML_STORE(block, &m_internal_ram32[base >> 1], I2, I0, SIZE_DWORD, SCALE_x4);	// store   [ram32],i2,i0,dword,scale_x4
+		UML_STORE(block, &ram[1], I2, I0, SIZE_WORD, SCALE_x4);			// store   [ram_1],i2,i0,word,scale_x4
+		UML_SHR(block, I0, I0, 16);										// shr     i0,i0,16
+		UML_STORE(block, &ram[0], I2, I0, SIZE_WORD, SCALE_x4);			// store   [ram],i2,i0,word,scale_x4
+	}
+	UML_JMP(block, label_done);											// jmp     done
+
+	UML_LABEL(block, label_slow);										// slow:
+	UML_CALLH(block, accessor);											// callh   dm|pm_write
+	UML_LABEL(block, label_done);										// done:
+}
+
 
 void adsp21062_device::generate_update_circular_buffer(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int g, int i)
 {
@@ -1710,6 +3224,50 @@ void adsp21062_device::generate_astat_copy(drcuml_block *block, compiler_state *
 	UML_MOV(block, mem(&m_core->astat_drc_copy.cacc), mem(&m_core->astat_drc.cacc));
 }
 
+// Records the operands of an ALU operation instead of computing AZ/AN/AV/AC, when that takes fewer stores.
+// x is the result for LOGIC and FLOAT, both operands are kept for ADD and SUB.
+bool adsp21062_device::generate_astat_lazy(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, int op, uml::parameter x, uml::parameter y)
+{
+	int required = population_count_32(desc->regreq[0] & ASTAT_LAZY_FLAGS);
+	int stores = (compiler->astat_lazy == op) ? 0 : 1;
+	stores += (op == ASTAT_LAZY_ADD || op == ASTAT_LAZY_SUB) ? 2 : 1;
+	if (required == 0 || required < stores)
+		return false;
+
+	if (compiler->astat_lazy != op)
+		UML_MOV(block, mem(&m_core->astat_lazy_op), op);								// mov     [astat_lazy_op],op
+	if (x.is_float_register())
+		UML_ICOPYFS(block, mem(&m_core->astat_lazy_x), x);							// icopyfs [astat_lazy_x],x
+	else
+		UML_MOV(block, mem(&m_core->astat_lazy_x), x);								// mov     [astat_lazy_x],x
+	if (op == ASTAT_LAZY_ADD || op == ASTAT_LAZY_SUB)
+		UML_MOV(block, mem(&m_core->astat_lazy_y), y);								// mov     [astat_lazy_y],y
+
+	compiler->astat_lazy = (desc->userflags & OP_USERFLAG_CONDITIONAL) ? ASTAT_LAZY_UNKNOWN : op;
+	compiler->astat_lazy_recorded = true;
+	return true;
+}
+
+// Writes out the ALU flags of a deferred operation, if there may be one.
+void adsp21062_device::generate_astat_materialize(drcuml_block *block, compiler_state *compiler)
+{
+	if (compiler->astat_lazy == ASTAT_LAZY_NONE)
+		return;
+
+	if (compiler->astat_lazy == ASTAT_LAZY_UNKNOWN)
+	{
+		code_label skip = compiler->labelnum++;
+		UML_CMP(block, mem(&m_core->astat_lazy_op), ASTAT_LAZY_NONE);					// cmp     [astat_lazy_op],ASTAT_LAZY_NONE
+		UML_JMPc(block, COND_E, skip);												// je      skip
+		UML_CALLH(block, *m_astat_materialize);										// callh   m_astat_materialize
+		UML_LABEL(block, skip);														// skip:
+	}
+	else
+		UML_CALLH(block, *m_astat_materialize);										// callh   m_astat_materialize
+
+	compiler->astat_lazy = ASTAT_LAZY_NONE;
+}
+
 
 
 void adsp21062_device::generate_call(drcuml_block *block, compiler_state *compiler, const opcode_desc *desc, bool delayslot)
@@ -1744,12 +3302,13 @@ void adsp21062_device::generate_call(drcuml_block *block, compiler_state *compil
 		if (desc->flags & OPFLAG_INTRABLOCK_BRANCH)
 			UML_JMP(block, desc->targetpc | 0x80000000);								// jmp      targetpc | 0x80000000
 		else
-			UML_HASHJMP(block, 0, desc->targetpc, *m_nocode);							// hashjmp  0,targetpc,nocode
+			UML_HASHJMP(block, mem(&m_core->codepage_slot[sharc_frontend::code_page(desc->targetpc)]), desc->targetpc, *m_nocode);	// hashjmp  [codepage_slot],targetpc,nocode
 	}
 	else
 	{
 		generate_update_cycles(block, &compiler_temp, mem(&m_core->jmpdest), TRUE);
-		UML_HASHJMP(block, 0, mem(&m_core->jmpdest), *m_nocode);						// hashjmp  0,jmpdest,nocode
+		generate_code_slot(block, mem(&m_core->jmpdest));								// <i1 = slot of jmpdest>
+		UML_HASHJMP(block, I1, mem(&m_core->jmpdest), *m_nocode);						// hashjmp  i1,jmpdest,nocode
 	}
 
 	// update compiler label
@@ -1786,12 +3345,15 @@ void adsp21062_device::generate_jump(drcuml_block *block, compiler_state *compil
 		if (desc->flags & OPFLAG_INTRABLOCK_BRANCH)
 			UML_JMP(block, desc->targetpc | 0x80000000);								// jmp      targetpc | 0x80000000
 		else
-			UML_HASHJMP(block, 0, desc->targetpc, *m_nocode);							// hashjmp  0,targetpc,nocode
+			UML_HASHJMP(block, mem(&m_core->codepage_slot[sharc_frontend::code_page(desc->targetpc)]), desc->targetpc, *m_nocode);	// hashjmp  [codepage_slot],targetpc,nocode
 	}
 	else
 	{
 		generate_update_cycles(block, &compiler_temp, mem(&m_core->jmpdest), TRUE);
-		UML_HASHJMP(block, 0, mem(&m_core->jmpdest), *m_nocode);						// hashjmp  0,jmpdest,nocode
+		if (compiler->return_sites)
+			generate_return_sites(block, &compiler_temp);
+		generate_code_slot(block, mem(&m_core->jmpdest));								// <i1 = slot of jmpdest>
+		UML_HASHJMP(block, I1, mem(&m_core->jmpdest), *m_nocode);						// hashjmp  i1,jmpdest,nocode
 	}
 
 	// update compiler label
@@ -1802,6 +3364,32 @@ void adsp21062_device::generate_jump(drcuml_block *block, compiler_state *compil
 	UML_MAPVAR(block, MAPVAR_CYCLES, compiler->cycles);									// mapvar  CYCLES,compiler->cycles
 }
 
+/*-------------------------------------------------
+generate_return_sites - in a frequently entered
+block, go straight to a call site of this block
+when a dynamic jump returns there
+-------------------------------------------------*/
+
+void adsp21062_device::generate_return_sites(drcuml_block *block, compiler_state *compiler)
+{
+	// [jmpdest] = target pc
+
+	int sites = 0;
+	for (const opcode_desc *desc = compiler->desclist; desc != nullptr && sites < HOT_RETURN_SITES; desc = desc->next())
+	{
+		if (!(desc->userflags & OP_USERFLAG_CALL))
+			continue;
+
+		UINT32 retpc = desc->pc + ((desc->delayslots > 0) ? 3 : 1);
+		if (!is_sequence_head(compiler->desclist, retpc))
+			continue;
+
+		UML_CMP(block, mem(&m_core->jmpdest), retpc);									// cmp      [jmpdest],retpc
+		UML_JMPc(block, COND_E, retpc | 0x80000000);									// jmp      retpc | 0x80000000,E
+		sites++;
+	}
+}
+
 /*-------------------------------------------------
 generate_write_ureg - UREG is read into I0
 -------------------------------------------------*/
@@ -1819,19 +3407,19 @@ void adsp21062_device::generate_read_ureg(drcuml_block *block, compiler_state *c
 			break;
 		// I0-7
 		case 0x10: case 0x11: case 0x12: case 0x13: case 0x14: case 0x15: case 0x16: case 0x17:
-			UML_MOV(block, I0, mem(&m_core->dag1.i[ureg & 7]));
+			UML_MOV(block, I0, DM_I(ureg & 7));
 			break;
 		// I8-15
 		case 0x18: case 0x19: case 0x1a: case 0x1b: case 0x1c: case 0x1d: case 0x1e: case 0x1f:
-			UML_MOV(block, I0, mem(&m_core->dag2.i[ureg & 7]));
+			UML_MOV(block, I0, PM_I(ureg & 7));
 			break;
 		// M0-7
 		case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
-			UML_MOV(block, I0, mem(&m_core->dag1.m[ureg & 7]));
+			UML_MOV(block, I0, DM_M(ureg & 7));
 			break;
 		// M8-15
 		case 0x28: case 0x29: case 0x2a: case 0x2b: case 0x2c: case 0x2d: case 0x2e: case 0x2f:
-			UML_MOV(block, I0, mem(&m_core->dag2.m[ureg & 7]));
+			UML_MOV(block, I0, PM_M(ureg & 7));
 			break;
 		// L0-7
 		case 0x30: case 0x31: case 0x32: case 0x33: case 0x34: case 0x35: case 0x36: case 0x37:
@@ -2594,37 +4182,13 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 					{
 						generate_read_ureg(block, compiler, desc, ureg, false);
 
-						// write
-						if (g)
-						{
-							// PM
-							if (ureg == 0xdb)	// PX is 48-bit
-								UML_CALLH(block, *m_pm_write48);
-							else
-								UML_CALLH(block, *m_pm_write32);
-						}
-						else
-						{
-							// DM
-							UML_CALLH(block, *m_dm_write32);
-						}
+						// write, PX is 48-bit in PM
+						generate_write_memory(block, compiler, g, g && ureg == 0xdb, address);
 					}
 					else
 					{
-						// read
-						if (g)
-						{
-							// PM
-							if (ureg == 0xdb)	// PX is 48-bit
-								UML_CALLH(block, *m_pm_read48);
-							else
-								UML_CALLH(block, *m_pm_read32);
-						}
-						else
-						{
-							// DM
-							UML_CALLH(block, *m_dm_read32);
-						}
+						// read, PX is 48-bit in PM
+						generate_read_memory(block, compiler, g, g && ureg == 0xdb, address);
 
 						generate_write_ureg(block, compiler, desc, ureg, false, 0);
 					}
@@ -2914,10 +4478,8 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 				else
 					generate_read_ureg(block, compiler, desc, ureg, ureg_is_astat);
 
-				if (ureg == 0xdb && (g))	// PX is 48-bit when writing to PM
-					UML_CALLH(block, *m_pm_write48);					// callh  pm_write48
-				else
-					UML_CALLH(block, (g) ? *m_pm_write32 : *m_dm_write32);	// callh  dm|pm_write32
+				// PX is 48-bit when writing to PM
+				generate_write_memory(block, compiler, g, ureg == 0xdb && (g), m_dag_hint[(g ? 8 : 0) + i]);
 			}
 			else
 			{
@@ -2931,10 +4493,8 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 				if (u == 0)	// pre-modify without update
 					UML_ADD(block, I1, I1, (g) ? PM_M(m) : DM_M(m));	// add    i1,i1,dm|pm[m]
 
-				if (ureg == 0xdb && (g))	// PX is 48-bit when reading from PM
-					UML_CALLH(block, *m_pm_read48);						// callh  pm_read48
-				else
-					UML_CALLH(block, (g) ? *m_pm_read32 : *m_dm_read32);	// callh  dm|pm_read32
+				// PX is 48-bit when reading from PM
+				generate_read_memory(block, compiler, g, ureg == 0xdb && (g), m_dag_hint[(g ? 8 : 0) + i]);
 				generate_write_ureg(block, compiler, desc, ureg, false, 0);
 			}
 
@@ -3045,7 +4605,7 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 						UML_MOV(block, I0, mem(&m_core->dreg_temp));		// mov    i0,[m_core->dreg_temp]
 					else
 						UML_MOV(block, I0, REG(dreg));						// mov    i0,reg[dreg]
-					UML_CALLH(block, (g) ? *m_pm_write32 : *m_dm_write32);	// callh  dm|pm_write32
+					generate_write_memory(block, compiler, g, false, m_dag_hint[(g ? 8 : 0) + i] + ((u == 0) ? mod : 0));
 				}
 				else
 				{
@@ -3058,7 +4618,7 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 					UML_MOV(block, I1, (g) ? PM_I(i) : DM_I(i));			// mov    i1,dm|pm[i]
 					if (u == 0)	// pre-modify without update
 						UML_ADD(block, I1, I1, mod);						// add    i1,i1,mod
-					UML_CALLH(block, (g) ? *m_pm_read32 : *m_dm_read32);	// callh  dm|pm_read32
+					generate_read_memory(block, compiler, g, false, m_dag_hint[(g ? 8 : 0) + i] + ((u == 0) ? mod : 0));
 					UML_MOV(block, REG(dreg), I0);							// mov    reg[dreg],i0
 				}
 
@@ -3126,7 +4686,7 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 						UML_MOV(block, I0, mem(&m_core->dreg_temp));		// mov    i0,[m_core->dreg_temp]
 					else
 						UML_MOV(block, I0, REG(dreg));						// mov    i0,reg[dreg]
-					UML_CALLH(block, (g) ? *m_pm_write32 : *m_dm_write32);	// callh  dm|pm_write32
+					generate_write_memory(block, compiler, g, false, m_dag_hint[(g ? 8 : 0) + i]);
 				}
 				else
 				{
@@ -3137,7 +4697,7 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 
 					// transfer
 					UML_MOV(block, I1, (g) ? PM_I(i) : DM_I(i));			// mov    i1,dm|pm[i]
-					UML_CALLH(block, (g) ? *m_pm_read32 : *m_dm_read32);	// callh  dm|pm_read32
+					generate_read_memory(block, compiler, g, false, m_dag_hint[(g ? 8 : 0) + i]);
 					UML_MOV(block, REG(dreg), I0);							// mov    reg[dreg],i0
 				}
 
@@ -3172,20 +4732,16 @@ int adsp21062_device::generate_opcode(drcuml_block *block, compiler_state *compi
 
 				generate_read_ureg(block, compiler, desc, ureg, false);
 
-				if (ureg == 0xdb && (g))	// PX is 48-bit when writing to PM
-					UML_CALLH(block, *m_pm_write48);						// callh  pm_write48
-				else
-					UML_CALLH(block, (g) ? *m_pm_write32 : *m_dm_write32);	// callh  dm|pm_write32
+				// PX is 48-bit when writing to PM
+				generate_write_memory(block, compiler, g, ureg == 0xdb && (g), m_dag_hint[(g ? 8 : 0) + i] + offset);
 			}
 			else
 			{
 				// DM|PM -> UREG
 				UML_ADD(block, I1, (g) ? PM_I(i) : DM_I(i), offset);		// add    i1,dm|pm[i],offset
 
-				if (ureg == 0xdb && (g))	// PX is 48-bit when reading from PM
-					UML_CALLH(block, *m_pm_read48);							// callh  pm_read48
-				else
-					UML_CALLH(block, (g) ? *m_pm_read32 : *m_dm_read32);	// callh  dm|pm_read32
+				// PX is 48-bit when reading from PM
+				generate_read_memory(block, compiler, g, ureg == 0xdb && (g), m_dag_hint[(g ? 8 : 0) + i] + offset);
 
 				generate_write_ureg(block, compiler, desc, ureg, false, 0);
 			}
@@ -3360,12 +4916,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 				UML_FSMUL(block, F0, F0, F1);
 				UML_FSADD(block, F2, F2, F3);
 
-				if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-					UML_FSCMP(block, F2, mem(&m_core->fp0));
-				if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-				if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-				if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
-				if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+				if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, F2, 0))
+				{
+					if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+						UML_FSCMP(block, F2, mem(&m_core->fp0));
+					if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+					if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+					if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
+					if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+				}
 				if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 				if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 				
@@ -3387,12 +4946,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 				UML_FSMUL(block, F0, F0, F1);
 				UML_FSSUB(block, F2, F2, F3);
 
-				if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-					UML_FSCMP(block, F2, mem(&m_core->fp0));
-				if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-				if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-				if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
-				if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+				if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, F2, 0))
+				{
+					if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+						UML_FSCMP(block, F2, mem(&m_core->fp0));
+					if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+					if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+					if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
+					if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+				}
 				if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 				if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 
@@ -3587,6 +5149,7 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 	else							// single-function operation
 	{
 		UINT32 operation = (opcode >> 12) & 0xff;
+		bool lazy;
 
 		switch ((opcode >> 20) & 3)
 		{
@@ -3617,21 +5180,29 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						return;
 
 					case 0x01:		// Rn = Rx + Ry
+						lazy = generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_ADD, REG(rx), REG(ry));
 						UML_ADD(block, REG(rn), REG(rx), REG(ry));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						if (!lazy)
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
+							if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x02:		// Rn = Rx - Ry
+						lazy = generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_SUB, REG(rx), REG(ry));
 						UML_SUB(block, REG(rn), REG(rx), REG(ry));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						if (!lazy)
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
+							if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
@@ -3660,72 +5231,96 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 
 					case 0x21:		// Rn = PASS Rx
 						UML_MOV(block, REG(rn), REG(rx));
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-							UML_CMP(block, REG(rn), 0);
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_LOGIC, REG(rn), 0))
+						{
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+								UML_CMP(block, REG(rn), 0);
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x22:		// Rn = -Rx
+						lazy = generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_SUB, 0, REG(rx));
 						UML_SUB(block, REG(rn), 0, REG(rx));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						if (!lazy)
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
+							if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x29:		// Rn = Rx + 1
+						lazy = generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_ADD, REG(rx), 1);
 						UML_ADD(block, REG(rn), REG(rx), 1);
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						if (!lazy)
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
+							if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x2a:		// Rn = Rx - 1
+						lazy = generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_SUB, REG(rx), 1);
 						UML_SUB(block, REG(rn), REG(rx), 1);
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						if (!lazy)
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, ASTAT_AV);
+							if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AC);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x40:		// Rn = Rx AND Ry
 						UML_AND(block, REG(rn), REG(rx), REG(ry));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_LOGIC, REG(rn), 0))
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x41:		// Rn = Rx OR Ry
 						UML_OR(block, REG(rn), REG(rx), REG(ry));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_LOGIC, REG(rn), 0))
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
 
 					case 0x42:		// Rn = Rx XOR Ry
 						UML_XOR(block, REG(rn), REG(rx), REG(ry));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_LOGIC, REG(rn), 0))
+						{
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
@@ -3734,12 +5329,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						UML_MOV(block, REG(rn), REG(rx));
 						UML_CMP(block, REG(rx), REG(ry));
 						UML_MOVc(block, COND_L, REG(rn), REG(ry));
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-							UML_CMP(block, REG(rn), 0);
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_LOGIC, REG(rn), 0))
+						{
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+								UML_CMP(block, REG(rn), 0);
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						return;
@@ -3756,12 +5354,12 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						UML_SUB(block, I1, REG(rx), REG(ry));
 						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, I2);
 						if (AN_CALC_REQUIRED) UML_SETc(block, COND_S, I3);
-						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, I4);
-						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, I5);
+						if (AV_CALC_REQUIRED) UML_SETc(block, COND_V, mem(&m_core->arg0));
+						if (AC_CALC_REQUIRED) UML_SETc(block, COND_C, mem(&m_core->arg1));
 						if (AZ_CALC_REQUIRED) UML_OR(block, ASTAT_AZ, ASTAT_AZ, I2);
 						if (AN_CALC_REQUIRED) UML_OR(block, ASTAT_AN, ASTAT_AN, I3);
-						if (AV_CALC_REQUIRED) UML_OR(block, ASTAT_AV, ASTAT_AV, I4);
-						if (AC_CALC_REQUIRED) UML_OR(block, ASTAT_AC, ASTAT_AC, I5);
+						if (AV_CALC_REQUIRED) UML_OR(block, ASTAT_AV, ASTAT_AV, mem(&m_core->arg0));
+						if (AC_CALC_REQUIRED) UML_OR(block, ASTAT_AC, ASTAT_AC, mem(&m_core->arg1));
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);
 						UML_MOV(block, REG(ra), I0);
@@ -3774,12 +5372,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						UML_FSCOPYI(block, F0, REG(rx));
 						UML_FSCOPYI(block, F1, REG(ry));
 						UML_FSADD(block, F0, F0, F1);
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-							UML_FSCMP(block, F0, mem(&m_core->fp0));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, F0, 0))
+						{
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+								UML_FSCMP(block, F0, mem(&m_core->fp0));
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 						UML_ICOPYFS(block, REG(rn), F0);
@@ -3790,12 +5391,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						UML_FSCOPYI(block, F0, REG(rx));
 						UML_FSCOPYI(block, F1, REG(ry));
 						UML_FSSUB(block, F0, F0, F1);
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-							UML_FSCMP(block, F0, mem(&m_core->fp0));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, F0, 0))
+						{
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+								UML_FSCMP(block, F0, mem(&m_core->fp0));
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);	// TODO
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 						UML_ICOPYFS(block, REG(rn), F0);
@@ -3842,15 +5446,18 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 
 					case 0xa1:		// Fn = PASS Fx
 						UML_MOV(block, REG(rn), REG(rx));
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, REG(rn), 0))
 						{
-							UML_FSCOPYI(block, F0, REG(rn));
-							UML_FSCMP(block, F0, mem(&m_core->fp0));
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+							{
+								UML_FSCOPYI(block, F0, REG(rn));
+								UML_FSCMP(block, F0, mem(&m_core->fp0));
+							}
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
 						}
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 						return;
@@ -3859,12 +5466,15 @@ void adsp21062_device::generate_compute(drcuml_block *block, compiler_state *com
 						UML_FSCOPYI(block, F0, REG(rx));
 						UML_FSNEG(block, F0, F0);
 						UML_ICOPYFS(block, REG(rn), F0);
-						if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
-							UML_FSCMP(block, F0, mem(&m_core->fp0));
-						if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
-						if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
-						if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
-						if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						if (!generate_astat_lazy(block, compiler, desc, ASTAT_LAZY_FLOAT, F0, 0))
+						{
+							if (AZ_CALC_REQUIRED || AN_CALC_REQUIRED)
+								UML_FSCMP(block, F0, mem(&m_core->fp0));
+							if (AZ_CALC_REQUIRED) UML_SETc(block, COND_Z, ASTAT_AZ);
+							if (AN_CALC_REQUIRED) UML_SETc(block, COND_C, ASTAT_AN);
+							if (AV_CALC_REQUIRED) UML_MOV(block, ASTAT_AV, 0);
+							if (AC_CALC_REQUIRED) UML_MOV(block, ASTAT_AC, 0);
+						}
 						if (AS_CALC_REQUIRED) UML_MOV(block, ASTAT_AS, 0);
 						if (AI_CALC_REQUIRED) UML_MOV(block, ASTAT_AI, 0);	// TODO
 						return;
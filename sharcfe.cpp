@@ -47,6 +47,13 @@
 #define AF_USED(desc)				do { (desc).regin[0] |= 1 << 30; } while(0)
 #define AF_MODIFIED(desc)			do { (desc).regout[0] |= 1 << 30; } while(0)
 
+#define ASTAT_FLAGS_MASK			0x7fff0000
+#define ASTAT_FLAGS_USED(desc)		do { (desc).regin[0] |= ASTAT_FLAGS_MASK; } while(0)
+
+#define CODE_PAGE_DEP_WORDS			(SHARC_CODE_PAGE_COUNT / 32)
+
+#define LOOP_STATE_USED(desc)		do { (desc).userflags |= OP_USERFLAG_LOOP_STATE; } while(0)
+
 #define ALU_FLAGS_MODIFIED(desc)	do { AZ_MODIFIED(desc);AN_MODIFIED(desc);AV_MODIFIED(desc);AC_MODIFIED(desc);AS_MODIFIED(desc);AI_MODIFIED(desc); } while(0)
 #define MULT_FLAGS_MODIFIED(desc)	do { MN_MODIFIED(desc);MV_MODIFIED(desc);MU_MODIFIED(desc);MI_MODIFIED(desc); } while(0)
 #define SHIFT_FLAGS_MODIFIED(desc)	do { SZ_MODIFIED(desc);SV_MODIFIED(desc);SS_MODIFIED(desc); } while(0)
@@ -76,6 +83,11 @@ sharc_frontend::sharc_frontend(adsp21062_device *sharc, UINT32 window_start, UIN
 		m_sharc(sharc)
 {
 	m_loopmap = std::make_unique<LOOP_ENTRY[]>(0x20000);
+	m_codemap = std::make_unique<UINT8[]>(SHARC_CODE_PAGE_COUNT);
+	m_flag_livein = std::make_unique<UINT32[]>(0x10000);
+	m_flag_deps = std::make_unique<UINT32[]>(SHARC_CODE_PAGE_COUNT * CODE_PAGE_DEP_WORDS);
+
+	flush();
 }
 
 
@@ -85,6 +97,231 @@ void sharc_frontend::flush()
 	LOOP_ENTRY* map = m_loopmap.get();
 
 	memset(map, 0, sizeof(LOOP_ENTRY) * 0x20000);
+	memset(m_codemap.get(), 0, SHARC_CODE_PAGE_COUNT);
+	memset(m_flag_deps.get(), 0, sizeof(UINT32) * SHARC_CODE_PAGE_COUNT * CODE_PAGE_DEP_WORDS);
+
+	// nothing is known about the code yet, so all flags are live everywhere
+	for (int i = 0; i < 0x10000; i++)
+		m_flag_livein[i] = ASTAT_FLAGS_MASK;
+}
+
+UINT32 sharc_frontend::code_offset(UINT32 pc)
+{
+	// block 1 is mirrored in 0x28000...0x3ffff, fold the mirrors onto the same offsets
+	UINT32 offset = pc & 0x1ffff;
+	if (offset >= 0x8000)
+		offset = 0x8000 | (offset & 0x7fff);
+
+	return offset;
+}
+
+UINT32 sharc_frontend::code_page(UINT32 pc)
+{
+	return code_offset(pc) >> SHARC_CODE_PAGE_SHIFT;
+}
+
+void sharc_frontend::clear_code_page(UINT32 page)
+{
+	m_codemap[page] = 0;
+
+	// liveness recorded for this page may no longer match the code
+	for (int i = 0; i < (1 << SHARC_CODE_PAGE_SHIFT); i++)
+		m_flag_livein[(page << SHARC_CODE_PAGE_SHIFT) + i] = ASTAT_FLAGS_MASK;
+}
+
+void sharc_frontend::pop_page_dependents(UINT32 page, UINT32 *deps)
+{
+	UINT32 *row = &m_flag_deps[page * CODE_PAGE_DEP_WORDS];
+
+	memcpy(deps, row, sizeof(UINT32) * CODE_PAGE_DEP_WORDS);
+	memset(row, 0, sizeof(UINT32) * CODE_PAGE_DEP_WORDS);
+}
+
+const opcode_desc *sharc_frontend::describe_block(UINT32 pc)
+{
+	const opcode_desc *desclist = describe_code(pc);
+
+	compute_flag_liveness(desclist);
+	return desclist;
+}
+
+static UINT32 delay_copy_flags(const opcode_desc *desc)
+{
+	UINT32 flags = 0;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AZ) flags |= 1 << 16;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AV) flags |= 1 << 17;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AN) flags |= 1 << 18;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_AC) flags |= 1 << 19;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_MN) flags |= 1 << 22;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_MV) flags |= 1 << 23;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_SV) flags |= 1 << 26;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_SZ) flags |= 1 << 27;
+	if (desc->userflags & OP_USERFLAG_ASTAT_DELAY_COPY_BTF) flags |= 1 << 29;
+	return flags;
+}
+
+// Backwards liveness of the ASTAT flags over the whole described window, including delay slots.
+// Successors outside the window use the liveness recorded when their own block was compiled, so
+// flags that are overwritten in the next block before being read are not computed either. The
+// result replaces the flag bits of regreq[0], which drcfe only computes within straight-line code.
+void sharc_frontend::compute_flag_liveness(const opcode_desc *desclist)
+{
+	struct flag_node
+	{
+		opcode_desc *desc;
+		std::vector<int> succ;	// successors inside the window
+		UINT32 extern_live;		// flags live in successors outside the window
+		UINT32 live_in;
+		UINT32 live_out;
+	};
+
+	std::vector<flag_node> nodes;
+	std::vector<int> mainindex;
+	UINT32 codepages[CODE_PAGE_DEP_WORDS] = { 0 };
+	UINT32 usedpages[CODE_PAGE_DEP_WORDS] = { 0 };
+
+	// build the node list, delay slots follow their branch
+	for (const opcode_desc *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		mainindex.push_back(nodes.size());
+		nodes.push_back({ const_cast<opcode_desc *>(desc), {}, 0, 0, 0 });
+
+		for (const opcode_desc *delay = desc->delay.first(); delay != nullptr; delay = delay->next())
+			nodes.push_back({ const_cast<opcode_desc *>(delay), {}, 0, 0, 0 });
+
+		UINT32 page = code_page(desc->physpc);
+		codepages[page / 32] |= 1 << (page % 32);
+	}
+
+	auto find_main = [&](UINT32 pc) -> int
+	{
+		for (int index : mainindex)
+			if (nodes[index].desc->pc == pc)
+				return index;
+		return -1;
+	};
+
+	auto extern_livein = [&](UINT32 pc) -> UINT32
+	{
+		if (pc < 0x20000 || pc >= 0x40000)
+			return ASTAT_FLAGS_MASK;
+
+		UINT32 live = m_flag_livein[code_offset(pc)];
+		if (live != ASTAT_FLAGS_MASK)
+		{
+			UINT32 page = code_page(pc);
+			usedpages[page / 32] |= 1 << (page % 32);
+		}
+		return live;
+	};
+
+	auto add_succ = [&](flag_node &node, UINT32 pc)
+	{
+		int index = find_main(pc);
+		if (index < 0)
+			node.extern_live |= extern_livein(pc);
+		else
+			node.succ.push_back(index);
+	};
+
+	// connect the nodes
+	for (int index : mainindex)
+	{
+		const opcode_desc *desc = nodes[index].desc;
+		int last = index;
+
+		// delay slots run in order after the branch, the last one continues where the branch goes
+		for (const opcode_desc *delay = desc->delay.first(); delay != nullptr; delay = delay->next())
+		{
+			nodes[last].succ.push_back(last + 1);
+			last++;
+		}
+
+		flag_node &node = nodes[last];
+		if (desc->flags & OPFLAG_IS_BRANCH)
+		{
+			if (desc->targetpc == BRANCH_TARGET_DYNAMIC)
+				node.extern_live |= ASTAT_FLAGS_MASK;
+			else
+				add_succ(node, desc->targetpc);
+		}
+		if (!(desc->flags & OPFLAG_IS_UNCONDITIONAL_BRANCH))
+		{
+			add_succ(node, desc->pc + 1 + desc->skipslots);
+
+			// a branch that isn't taken may skip its delay slots as well
+			if (last != index)
+			{
+				add_succ(nodes[index], desc->pc + 1);
+				add_succ(nodes[index], desc->pc + 1 + desc->skipslots);
+			}
+		}
+	}
+
+	// iterate until nothing changes
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (int i = nodes.size() - 1; i >= 0; i--)
+		{
+			flag_node &node = nodes[i];
+			const opcode_desc *desc = node.desc;
+
+			UINT32 live_out = node.extern_live;
+			for (int succ : node.succ)
+				live_out |= nodes[succ].live_in;
+
+			// the delay copy for conditional loops reads the flags after this instruction
+			live_out |= delay_copy_flags(desc);
+
+			UINT32 gen = desc->regin[0] & ASTAT_FLAGS_MASK;
+			UINT32 kill = desc->regout[0] & ASTAT_FLAGS_MASK;
+
+			// a conditional instruction may leave the flags alone, and anything we can't compile needs them all
+			if (desc->userflags & OP_USERFLAG_CONDITIONAL)
+				kill = 0;
+			if (desc->flags & (OPFLAG_INVALID_OPCODE | OPFLAG_COMPILER_UNMAPPED))
+				gen = ASTAT_FLAGS_MASK;
+
+			UINT32 live_in = (live_out & ~kill) | gen;
+			if (live_in != node.live_in || live_out != node.live_out)
+			{
+				node.live_in = live_in;
+				node.live_out = live_out;
+				changed = true;
+			}
+		}
+	}
+
+	for (auto &node : nodes)
+	{
+		opcode_desc *desc = node.desc;
+		desc->regreq[0] = (desc->regreq[0] & ~ASTAT_FLAGS_MASK) | (desc->regout[0] & node.live_out & ASTAT_FLAGS_MASK);
+	}
+
+	// remember the liveness at each instruction, for the blocks branching here later
+	for (int index : mainindex)
+	{
+		const opcode_desc *desc = nodes[index].desc;
+		if (desc->pc >= 0x20000 && desc->pc < 0x40000)
+			m_flag_livein[code_offset(desc->pc)] = nodes[index].live_in;
+	}
+
+	// if any page used here changes, the liveness recorded in this block's pages is stale
+	for (int word = 0; word < CODE_PAGE_DEP_WORDS; word++)
+	{
+		UINT32 pages = codepages[word] | usedpages[word];
+		for (int bit = 0; bit < 32; bit++)
+		{
+			if (pages & (1 << bit))
+			{
+				UINT32 *row = &m_flag_deps[(word * 32 + bit) * CODE_PAGE_DEP_WORDS];
+				for (int i = 0; i < CODE_PAGE_DEP_WORDS; i++)
+					row[i] |= codepages[i];
+			}
+		}
+	}
 }
 
 void sharc_frontend::add_loop_entry(UINT32 pc, UINT8 type, UINT32 start_pc, UINT8 looptype, UINT8 condition)
@@ -124,6 +361,36 @@ void sharc_frontend::insert_loop(const LOOP_DESCRIPTOR &loopdesc)
 		add_loop_entry(loopdesc.astat_check_pc, LOOP_ENTRY_ASTAT_CHECK, loopdesc.start_pc, loopdesc.type, loopdesc.condition);
 }
 
+// register the loop of a DO instruction that was run outside of translated code,
+// returns true if the loop was not known before
+bool sharc_frontend::add_do_loop(UINT32 pc, LOOP_DESCRIPTOR &loop)
+{
+	UINT64 opcode = m_sharc->pm_read48(pc);
+	int offset = SIGN_EXTEND24(opcode & 0xffffff);
+
+	loop.start_pc = pc + 1;
+	loop.end_pc = pc + offset;
+
+	if (((opcode >> 40) & 0xff) == 0x0e)
+	{
+		loop.type = LOOP_TYPE_CONDITIONAL;
+		loop.condition = (opcode >> 33) & 0x1f;
+		loop.astat_check_pc = loop.end_pc - 2;
+	}
+	else
+	{
+		loop.type = LOOP_TYPE_COUNTER;
+		loop.condition = 0;
+		loop.astat_check_pc = 0xffffffff;
+	}
+
+	if (is_loop_evaluation(loop.end_pc))
+		return false;
+
+	insert_loop(loop);
+	return true;
+}
+
 bool sharc_frontend::is_loop_evaluation(UINT32 pc)
 {
 	UINT32 l2 = pc >> 17;
@@ -173,11 +440,15 @@ bool sharc_frontend::is_astat_delay_check(UINT32 pc)
 bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 {
 	//UINT64 opcode = desc.opptr.q[0] = m_sharc.m_direct->read_qword(desc.physpc, 0);
-	UINT64 opcode = desc.opptr.q[0] = m_sharc->pm_read48(desc.physpc);
+	// the worker may describe while the interpreter runs, so don't rebuild the 48-bit view here
+	UINT64 opcode = desc.opptr.q[0] = m_sharc->read_code48(desc.physpc);
 
 	desc.length = 1;
 	desc.cycles = 1;
 
+	// mark the page as containing translated code, so that writes to it invalidate the blocks
+	m_codemap[code_page(desc.physpc)] = 1;
+
 	// handle looping
 	/*
 	if (m_loop.size() > 0)
@@ -355,6 +626,9 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 
 					desc.targetpc = address;
 					desc.delayslots = (j) ? 2 : 0;
+
+					if ((opcode >> 39) & 0x1)
+						desc.userflags |= OP_USERFLAG_CALL;
 					break;
 				}
 
@@ -373,6 +647,9 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 
 					desc.targetpc = desc.pc + SIGN_EXTEND24(address);
 					desc.delayslots = (j) ? 2 : 0;
+
+					if ((opcode >> 39) & 0x1)
+						desc.userflags |= OP_USERFLAG_CALL;
 					break;
 				}
 
@@ -398,6 +675,9 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 
 					desc.targetpc = BRANCH_TARGET_DYNAMIC;
 					desc.delayslots = (j) ? 2 : 0;
+
+					if ((opcode >> 39) & 0x1)
+						desc.userflags |= OP_USERFLAG_CALL;
 					break;
 				}
 
@@ -419,6 +699,9 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 					desc.targetpc = desc.pc + SIGN_EXTEND6((opcode >> 27) & 0x3f);
 					desc.delayslots = (j) ? 2 : 0;
 
+					if ((opcode >> 39) & 0x1)
+						desc.userflags |= OP_USERFLAG_CALL;
+
 					break;
 				}
 
@@ -474,6 +757,7 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 					loop.condition = 0;
 
 					insert_loop(loop);
+					LOOP_STATE_USED(desc);
 					break;
 				}
 
@@ -493,6 +777,7 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 					loop.condition = 0;
 
 					insert_loop(loop);
+					LOOP_STATE_USED(desc);
 					break;
 				}
 
@@ -512,6 +797,7 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 						fatalerror("describe_compute: conditional loop < 2 at %08X", desc.pc);
 
 					insert_loop(loop);
+					LOOP_STATE_USED(desc);
 					break;
 				}
 
@@ -551,6 +837,10 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 					int sreg = (opcode >> 32) & 0xf;
 					UINT32 data = (UINT32)(opcode);
 
+					// MODE1 changes are delayed by one instruction
+					if (sreg == 0xb)
+						LOOP_STATE_USED(desc);
+
 					switch (bop)
 					{
 						case 0:		// SET
@@ -653,6 +943,9 @@ bool sharc_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 				}
 
 				case 0x17:			// push|pop stacks / flush cache		|000|10111|					
+					// PUSH STS saves ASTAT
+					ASTAT_FLAGS_USED(desc);
+					LOOP_STATE_USED(desc);
 					break;
 
 				case 0x18:			// cjump								|000|11000|
@@ -1691,14 +1984,11 @@ bool sharc_frontend::describe_ureg_access(opcode_desc &desc, int reg, UREG_ACCES
 		case 0x63:		// PC
 			break;
 		case 0x64:		// PCSTK
-			break;
 		case 0x65:		// PCSTKP
-			break;
 		case 0x66:		// LADDR
-			break;
 		case 0x67:		// CURLCNTR
-			break;
 		case 0x68:		// LCNTR
+			LOOP_STATE_USED(desc);
 			break;
 		case 0x70:		// USTAT1
 			break;
@@ -1706,9 +1996,11 @@ bool sharc_frontend::describe_ureg_access(opcode_desc &desc, int reg, UREG_ACCES
 			break;
 		case 0x79:		// IRPTL
 			break;
-		case 0x7a:		// MODE1
+		case 0x7a:		// MODE2
 			break;
-		case 0x7b:		// MODE2
+		case 0x7b:		// MODE1
+			if (access == UREG_WRITE)
+				LOOP_STATE_USED(desc);
 			break;
 
 		case 0x7c:		// ASTAT
@@ -1804,6 +2096,9 @@ bool sharc_frontend::describe_shiftop_imm(opcode_desc &desc, int shiftop, int rn
 
 void sharc_frontend::describe_if_condition(opcode_desc &desc, int condition)
 {
+	if (!m_sharc->if_condition_always_true(condition))
+		desc.userflags |= OP_USERFLAG_CONDITIONAL;
+
 	switch (condition)
 	{
 		case 0x00:  AZ_USED(desc); break;                  /* EQ */
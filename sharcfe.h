@@ -21,6 +21,15 @@ public:
 	sharc_frontend(adsp21062_device *sharc, UINT32 window_start, UINT32 window_end, UINT32 max_sequence);
 	void flush();
 
+	const opcode_desc *describe_block(UINT32 pc);
+
+	static UINT32 code_offset(UINT32 pc);
+	static UINT32 code_page(UINT32 pc);
+	UINT8 *codemap() { return m_codemap.get(); }
+	void clear_code_page(UINT32 page);
+	void set_code_page(UINT32 page) { m_codemap[page] = 1; }
+	void pop_page_dependents(UINT32 page, UINT32 *deps);
+
 	enum UREG_ACCESS
 	{
 		UREG_READ,
@@ -57,6 +66,10 @@ public:
 		int condition;
 	};
 
+	const LOOP_ENTRY &get_loop_entry(UINT32 pc) const { return m_loopmap[pc & 0x1ffff]; }
+	void add_loop_entry(UINT32 pc, UINT8 type, UINT32 start_pc, UINT8 looptype, UINT8 condition);
+	bool add_do_loop(UINT32 pc, LOOP_DESCRIPTOR &loop);
+
 protected:
 	// required overrides
 	virtual bool describe(opcode_desc &desc, const opcode_desc *prev) override;
@@ -67,8 +80,9 @@ private:
 	bool describe_shiftop_imm(opcode_desc &desc, int shiftop, int rn, int rx);
 	void describe_if_condition(opcode_desc &desc, int condition);
 
+	void compute_flag_liveness(const opcode_desc *desclist);
+
 	void insert_loop(const LOOP_DESCRIPTOR &loopdesc);
-	void add_loop_entry(UINT32 pc, UINT8 type, UINT32 start_pc, UINT8 looptype, UINT8 condition);
 	bool is_loop_evaluation(UINT32 pc);
 	bool is_loop_start(UINT32 pc);
 	bool is_astat_delay_check(UINT32 pc);
@@ -76,6 +90,9 @@ private:
 	adsp21062_device *m_sharc;
 
 	std::unique_ptr<LOOP_ENTRY[]> m_loopmap;
+	std::unique_ptr<UINT8[]> m_codemap;
+	std::unique_ptr<UINT32[]> m_flag_livein;		// flags live on entry to each code offset
+	std::unique_ptr<UINT32[]> m_flag_deps;			// per page, the pages whose liveness was derived from it
 };
 
 #endif /* __SHARCFE_H__ */